@@ -21,12 +21,21 @@
 
 const uint8_t AX25_RADIO_SYMBOL_LENGTH = 20U;      // At 24 kHz sample rate
 
+const uint16_t AX25_SAMPLE_RATE = 24000U;
+const uint16_t AX25_BIT_RATE    = 1200U;
+const uint16_t AX25_MARK_FREQ   = 1200U;
+const uint16_t AX25_SPACE_FREQ  = 2200U;
+
 const uint8_t AX25_FRAME_START = 0x7EU;
 const uint8_t AX25_FRAME_END   = 0x7EU;
 const uint8_t AX25_FRAME_ABORT = 0xFEU;
 
 const uint8_t AX25_MAX_ONES    = 5U;
 
+// Mode 5 sends IL2P frames instead of HDLC, the receiver decodes both in either mode
+const uint8_t  AX25_IL2P_MODE = 5U;
+const uint32_t AX25_IL2P_SYNC = 0xF15E48U;         // The standard IL2P sync word, sent MSB first
+
 const uint16_t AX25_MIN_FRAME_LENGTH = 17U;        // Callsign (7) + Callsign (7) + Control (1) + Checksum (2)
 
 const uint16_t AX25_MAX_FRAME_LENGTH = 330U;       // Callsign (7) + Callsign (7) + 8 Digipeaters (56) +
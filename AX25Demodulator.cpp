@@ -64,7 +64,6 @@ const uint32_t PLL_FILTER_LEN = 7U;
 float32_t PLL_FILTER_COEFFS[] = {3.196252e-02F, 1.204223e-01F, 2.176819e-01F, 2.598666e-01F, 2.176819e-01F, 1.204223e-01F, 3.196252e-02F};
 
 CAX25Demodulator::CAX25Demodulator(int8_t n) :
-m_frame(),
 m_twist(n),
 m_lpfFilter(),
 m_lpfState(),
@@ -79,11 +78,10 @@ m_pllCount(0.0F),
 m_pllJitter(0.0F),
 m_pllDCD(false),
 m_iirHistory(),
-m_hdlcOnes(0U),
-m_hdlcFlag(false),
-m_hdlcBuffer(0U),
-m_hdlcBits(0U),
-m_hdlcState(AX25_IDLE)
+m_hdlc(),
+m_fx25(),
+m_pending(),
+m_il2p()
 {
   m_delayLine = new bool[DELAY_LEN];
 
@@ -123,18 +121,47 @@ bool CAX25Demodulator::process(q15_t* samples, uint8_t length, CAX25Frame& frame
     if (sample) {
       // We will only ever get one frame because there are
       // not enough bits in a block for more than one.
-      if (result) {
-        HDLC(NRZI(bit));
-      } else {
-        result = HDLC(NRZI(bit));
-        if (result) {
-          // Copy the frame data.
-          ::memcpy(frame.m_data, m_frame.m_data, AX25_MAX_PACKET_LEN);
-          frame.m_length = m_frame.m_length;
-          frame.m_fcs    = m_frame.m_fcs;
-          m_frame.m_length = 0U;
+      bool b = NRZI(bit);
+
+      // An FX.25 codeword also decodes as a plain frame, which is held back until the codeword is
+      // complete so that the same frame is not reported twice
+      bool ok = m_hdlc.process(b, frame);
+      if (ok) {
+        if (m_fx25.isBusy()) {
+          ::memcpy(m_pending.m_data, frame.m_data, AX25_MAX_PACKET_LEN);
+          m_pending.m_length = frame.m_length;
+          m_pending.m_fcs    = frame.m_fcs;
+          m_pending.m_start  = frame.m_start;
+        } else {
+          stats.increment(STATS_AX25_FRAMES);
+          result = true;
         }
       }
+
+      bool busy = m_fx25.isBusy();
+
+      ok = m_fx25.process(b, frame);
+      if (ok) {
+        stats.increment(STATS_FX25_FRAMES);
+        result = true;
+      } else if (busy && !m_fx25.isBusy() && (m_pending.m_length > 0U)) {
+        ::memcpy(frame.m_data, m_pending.m_data, AX25_MAX_PACKET_LEN);
+        frame.m_length = m_pending.m_length;
+        frame.m_fcs    = m_pending.m_fcs;
+        frame.m_start  = m_pending.m_start;
+        stats.increment(STATS_AX25_FRAMES);
+        result = true;
+      }
+
+      if (busy && !m_fx25.isBusy())
+        m_pending.m_length = 0U;
+
+      // IL2P is sent without NRZI or bit stuffing
+      ok = m_il2p.process(bit, frame);
+      if (ok) {
+        stats.increment(STATS_AFSK_IL2P_FRAMES);
+        result = true;
+      }
     }
   }
 
@@ -200,88 +227,6 @@ bool CAX25Demodulator::PLL(bool input)
   return sample;
 }
 
-bool CAX25Demodulator::HDLC(bool b)
-{
-  if (m_hdlcOnes == AX25_MAX_ONES) {
-    if (b) {
-      // flag byte
-      m_hdlcFlag = true;
-    } else {
-      // bit stuffing...
-      m_hdlcFlag = false;
-      m_hdlcOnes = 0U;
-      return false;
-    }
-  }
-
-  m_hdlcBuffer >>= 1;
-  m_hdlcBuffer |= b ? 128U : 0U;
-  m_hdlcBits++;                      // Free-running until Sync byte.
-
-  if (b)
-    m_hdlcOnes++;
-  else
-    m_hdlcOnes = 0U;
-
-  if (m_hdlcFlag) {
-    bool result = false;
-
-    switch (m_hdlcBuffer) {
-      case AX25_FRAME_END:
-        if (m_frame.m_length >= AX25_MIN_FRAME_LENGTH) {
-          result = m_frame.checkCRC();
-          if (!result)
-              m_frame.m_length = 0U;
-        } else {
-            m_frame.m_length = 0U;
-        }
-        m_hdlcState = AX25_SYNC;
-        m_hdlcFlag = false;
-        m_hdlcBits = 0U;
-        break;
-
-      case AX25_FRAME_ABORT:
-        // Frame aborted
-        m_frame.m_length = 0U;
-        m_hdlcState = AX25_IDLE;
-        m_hdlcFlag = false;
-        m_hdlcBits = 0U;
-        break;
-
-      default:
-        break;
-    }
-
-    return result;
-  }
-
-  switch (m_hdlcState) {
-    case AX25_IDLE:
-      break;
-
-    case AX25_SYNC:
-      if (m_hdlcBits == 8U) {    // 8th bit.
-        // Start of frame data.
-        m_hdlcState = AX25_RECEIVE;
-        m_frame.append(m_hdlcBuffer);
-        m_hdlcBits = 0U;
-      }
-      break;
-
-    case AX25_RECEIVE:
-      if (m_hdlcBits == 8U) {    // 8th bit.
-        m_frame.append(m_hdlcBuffer);
-        m_hdlcBits = 0U;
-      }
-      break;
-
-    default:
-      break;
-  }
-
-  return false;
-}
-
 void CAX25Demodulator::setTwist(int8_t n)
 {
   m_twist.setTwist(n);
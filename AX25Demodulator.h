@@ -22,14 +22,11 @@
 #define  AX25Demodulator_H
 
 #include "AX25Frame.h"
+#include "AX25HDLC.h"
+#include "FX25RX.h"
+#include "IL2PDeframer.h"
 #include "AX25Twist.h"
 
-enum AX25_STATE {
-  AX25_IDLE,
-  AX25_SYNC,
-  AX25_RECEIVE
-};
-
 class CAX25Demodulator {
 public:
   CAX25Demodulator(int8_t n);
@@ -41,7 +38,6 @@ public:
   bool isDCD();
 
 private:
-  CAX25Frame           m_frame;
   CAX25Twist           m_twist;
   arm_fir_instance_q15 m_lpfFilter;
   q15_t                m_lpfState[70U];     // NoTaps + BlockSize - 1, 48 + 20 - 1 plus some spare
@@ -56,16 +52,14 @@ private:
   float32_t            m_pllJitter;
   bool                 m_pllDCD;
   float32_t            m_iirHistory[5U];
-  uint16_t             m_hdlcOnes;
-  bool                 m_hdlcFlag;
-  uint16_t             m_hdlcBuffer;
-  uint16_t             m_hdlcBits;
-  AX25_STATE           m_hdlcState;
+  CAX25HDLC            m_hdlc;
+  CFX25RX              m_fx25;
+  CAX25Frame           m_pending;
+  CIL2PDeframer        m_il2p;
 
   bool delay(bool b);
   bool NRZI(bool b);
   bool PLL(bool b);
-  bool HDLC(bool b);
   float32_t iir(float32_t input);
 };
 
@@ -58,7 +58,8 @@ const uint16_t CCITT_TABLE[] = {
 CAX25Frame::CAX25Frame(const uint8_t* data, uint16_t length) :
 m_data(),
 m_length(0U),
-m_fcs(0U)
+m_fcs(0U),
+m_start(0U)
 {
   for (uint16_t i = 0U; i < length && i < (AX25_MAX_PACKET_LEN - 2U); i++)
     m_data[m_length++] = data[i];
@@ -67,7 +68,8 @@ m_fcs(0U)
 CAX25Frame::CAX25Frame() :
 m_data(),
 m_length(0U),
-m_fcs(0U)
+m_fcs(0U),
+m_start(0U)
 {
 }
 
@@ -37,6 +37,7 @@ public:
   uint8_t  m_data[AX25_MAX_PACKET_LEN];
   uint16_t m_length;
   uint16_t m_fcs;
+  uint32_t m_start;    // The sample index of the sync or last opening flag
 };
 
 #endif
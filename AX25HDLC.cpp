@@ -0,0 +1,135 @@
+/*
+ *   Copyright (C) 2020,2024 by Jonathan Naylor G4KLX
+ *   Copyright 2015-2019 Mobilinkd LLC <rob@mobilinkd.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "Globals.h"
+#include "AX25HDLC.h"
+#include "AX25Defines.h"
+
+CAX25HDLC::CAX25HDLC() :
+m_frame(),
+m_ones(0U),
+m_flag(false),
+m_buffer(0U),
+m_bits(0U),
+m_state(AX25_IDLE)
+{
+}
+
+void CAX25HDLC::reset()
+{
+  m_frame.m_length = 0U;
+  m_ones   = 0U;
+  m_flag   = false;
+  m_buffer = 0U;
+  m_bits   = 0U;
+  m_state  = AX25_IDLE;
+}
+
+bool CAX25HDLC::process(bool b, CAX25Frame& frame)
+{
+  if (m_ones == AX25_MAX_ONES) {
+    if (b) {
+      // flag byte
+      m_flag = true;
+    } else {
+      // bit stuffing...
+      m_flag = false;
+      m_ones = 0U;
+      return false;
+    }
+  }
+
+  m_buffer >>= 1;
+  m_buffer |= b ? 128U : 0U;
+  m_bits++;                          // Free-running until Sync byte.
+
+  if (b)
+    m_ones++;
+  else
+    m_ones = 0U;
+
+  if (m_flag) {
+    bool result = false;
+
+    switch (m_buffer) {
+      case AX25_FRAME_END:
+        if (m_frame.m_length >= AX25_MIN_FRAME_LENGTH) {
+          result = m_frame.checkCRC();
+          if (!result)
+            stats.increment(STATS_HDLC_CRC_ERRORS);
+
+          if (result) {
+            // Copy the frame data.
+            ::memcpy(frame.m_data, m_frame.m_data, AX25_MAX_PACKET_LEN);
+            frame.m_length = m_frame.m_length;
+            frame.m_fcs    = m_frame.m_fcs;
+            frame.m_start  = m_frame.m_start;
+          }
+        }
+        m_frame.m_length = 0U;
+        m_frame.m_start  = io.getRXSampleIndex();
+        m_state = AX25_SYNC;
+        m_flag = false;
+        m_bits = 0U;
+        break;
+
+      case AX25_FRAME_ABORT:
+        // Frame aborted
+        m_frame.m_length = 0U;
+        m_state = AX25_IDLE;
+        m_flag = false;
+        m_bits = 0U;
+        break;
+
+      default:
+        break;
+    }
+
+    return result;
+  }
+
+  switch (m_state) {
+    case AX25_IDLE:
+      break;
+
+    case AX25_SYNC:
+      if (m_bits == 8U) {    // 8th bit.
+        // Start of frame data.
+        m_state = AX25_RECEIVE;
+        m_frame.append(m_buffer);
+        m_bits = 0U;
+      }
+      break;
+
+    case AX25_RECEIVE:
+      if (m_bits == 8U) {    // 8th bit.
+        m_frame.append(m_buffer);
+        m_bits = 0U;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return false;
+}
+
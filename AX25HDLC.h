@@ -0,0 +1,52 @@
+/*
+ *   Copyright (C) 2020,2023,2024 by Jonathan Naylor G4KLX
+ *   Copyright 2015-2019 Mobilinkd LLC <rob@mobilinkd.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(AX25HDLC_H)
+#define  AX25HDLC_H
+
+#include "AX25Frame.h"
+
+enum AX25_STATE {
+  AX25_IDLE,
+  AX25_SYNC,
+  AX25_RECEIVE
+};
+
+class CAX25HDLC {
+public:
+  CAX25HDLC();
+
+  // Takes the NRZI decoded bits, and copies out a frame once its CRC is valid
+  bool process(bool b, CAX25Frame& frame);
+
+  void reset();
+
+private:
+  CAX25Frame           m_frame;
+  uint16_t             m_ones;
+  bool                 m_flag;
+  uint16_t             m_buffer;
+  uint16_t             m_bits;
+  AX25_STATE           m_state;
+};
+
+#endif
+
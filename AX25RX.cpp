@@ -87,9 +87,9 @@ void CAX25RX::samples(q15_t* samples, uint8_t length)
     if (frame.m_fcs != m_lastFCS || m_count > 2U) {
       m_lastFCS = frame.m_fcs;
       m_count   = 0U;
-      serial.writeKISSData(KISS_TYPE_DATA, frame.m_data, frame.m_length - 2U);
+      serial.writeKISSRXData(frame.m_data, frame.m_length - 2U, frame.m_start);
     }
-    DEBUG1("AX.25 decoder 1 reported");
+    LOG_MODE1_INFO("AX.25 decoder 1 reported");
   }
 
   ret = m_demod2.process(output, length, frame);
@@ -97,9 +97,9 @@ void CAX25RX::samples(q15_t* samples, uint8_t length)
     if (frame.m_fcs != m_lastFCS || m_count > 2U) {
       m_lastFCS = frame.m_fcs;
       m_count   = 0U;
-      serial.writeKISSData(KISS_TYPE_DATA, frame.m_data, frame.m_length - 2U);
+      serial.writeKISSRXData(frame.m_data, frame.m_length - 2U, frame.m_start);
     }
-    DEBUG1("AX.25 decoder 2 reported");
+    LOG_MODE1_INFO("AX.25 decoder 2 reported");
   }
 
   ret = m_demod3.process(output, length, frame);
@@ -107,9 +107,9 @@ void CAX25RX::samples(q15_t* samples, uint8_t length)
     if (frame.m_fcs != m_lastFCS || m_count > 2U) {
       m_lastFCS = frame.m_fcs;
       m_count   = 0U;
-      serial.writeKISSData(KISS_TYPE_DATA, frame.m_data, frame.m_length - 2U);
+      serial.writeKISSRXData(frame.m_data, frame.m_length - 2U, frame.m_start);
     }
-    DEBUG1("AX.25 decoder 3 reported");
+    LOG_MODE1_INFO("AX.25 decoder 3 reported");
   }
 
   bool dcd1 = m_demod1.isDCD();
@@ -24,6 +24,7 @@
 #include "AX25Defines.h"
 #include "AX25Frame.h"
 
+#include <cstring>
 
 const uint8_t START_FLAG[] = { AX25_FRAME_START };
 const uint8_t END_FLAG[]   = { AX25_FRAME_END };
@@ -38,47 +39,67 @@ const uint8_t BIT_MASK_TABLE2[] = { 0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x
 #define WRITE_BIT2(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE2[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE2[(i)&7])
 #define READ_BIT2(p,i)    (p[(i)>>3] & BIT_MASK_TABLE2[(i)&7])
 
-const uint16_t AUDIO_TABLE_LEN = 120U;
-
-const q15_t AUDIO_TABLE_DATA[] = {
-  0, 214, 428, 641, 851, 1060, 1265, 1468, 1666, 1859, 2048, 2230, 2407, 2577, 2740, 2896, 3043, 3182, 3313, 3434, 3546, 3649,
-  3741, 3823, 3895, 3955, 4006, 4045, 4073, 4089, 4095, 4089, 4073, 4045, 4006, 3955, 3895, 3823, 3741, 3649, 3546, 3434, 3313,
-  3182, 3043, 2896, 2740, 2577, 2407, 2230, 2048, 1859, 1666, 1468, 1265, 1060, 851, 641, 428, 214, 0, -214, -428, -641, -851,
-  -1060, -1265, -1468, -1666, -1859, -2047, -2230, -2407, -2577, -2740, -2896, -3043, -3182, -3313, -3434, -3546, -3649, -3741,
-  -3823, -3895, -3955, -4006, -4045, -4073, -4089, -4095, -4089, -4073, -4045, -4006, -3955, -3895, -3823, -3741, -3649, -3546,
-  -3434, -3313, -3182, -3043, -2896, -2740, -2577, -2407, -2230, -2047, -1859, -1666, -1468, -1265, -1060, -851, -641, -428, -214
+// The number of samples rendered per call to io.write
+const uint16_t TX_BLOCK_LENGTH = 100U;
+
+// The NCO phase increments for the two tones, rounded to nearest
+const uint32_t MARK_INCREMENT  = uint32_t(((uint64_t(AX25_MARK_FREQ)  << 32) + AX25_SAMPLE_RATE / 2U) / AX25_SAMPLE_RATE);
+const uint32_t SPACE_INCREMENT = uint32_t(((uint64_t(AX25_SPACE_FREQ) << 32) + AX25_SAMPLE_RATE / 2U) / AX25_SAMPLE_RATE);
+
+// A quarter of a sine wave, the top ten bits of the phase give a 1024 point cycle
+const q15_t SINE_TABLE[] = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210,
+  4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767, 7962, 8157, 8351,
+  8545, 8739, 8933, 9126, 9319, 9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605, 11793, 11980,
+  12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037, 18204, 18371,
+  18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250,
+  21403, 21554, 21705, 21856, 22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592, 23731, 23870,
+  24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201, 25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+  26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208,
+  28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874,
+  29956, 30037, 30117, 30195, 30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050, 31113, 31176,
+  31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+  32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589, 32609, 32628,
+  32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766, 32767
 };
 
+// Attenuation of 0 to 12 dB in Q15
+const q15_t PREEMPHASIS_TABLE[] = { 32767, 29205, 26029, 23198, 20675, 18427, 16423, 14637, 13045, 11627, 10362, 9235, 8231 };
+
 CAX25TX::CAX25TX() :
 m_poBuffer(),
 m_poLen(0U),
 m_poPtr(0U),
-m_tablePtr(0U),
+m_poBase(0U),
+m_poStart(0U),
+m_phase(0U),
+m_bitClock(0U),
+m_bit(false),
 m_nrzi(false),
 m_level(MODE1_TX_LEVEL * 128),
+m_markLevel(0),
+m_spaceLevel(0),
 m_txDelay((TX_DELAY / 10U) * 12U),
+m_fx25(),
+m_il2p(),
+m_il2pBuffer(400U),
 m_tokens()
 {
+  m_fx25.setCheckBytes(MODE1_FX25);
+
+  m_il2p.setMaxFEC(MODE2_MAX_FEC == 1);
+
+  setLevels();
 }
 
 void CAX25TX::process()
 {
-  if (!m_duplex) {
-    // Nothing left to transmit, send the packet tokens back
-    if (!m_tx && (m_poLen == 0U)) {
-      for (const auto& token : m_tokens)
-        serial.writeKISSAck(token);
-      m_tokens.clear();
-      return;
-    }
-  } else {
-    // Send the tokens back immediately as the packets can be transmitted immediately too
-    for (const auto& token : m_tokens)
-      serial.writeKISSAck(token);
-    m_tokens.clear();
-    if (m_poLen == 0U)
-      return;
-  }
+  // Send back the tokens of the packets that have been transmitted
+  m_tokens.process();
+
+  if (m_poLen == 0U)
+    return;
 
   if (m_poPtr == 0U) {
     bool tx = io.canTX();
@@ -88,38 +109,126 @@ void CAX25TX::process()
 
   uint16_t space = io.getSpace();
 
-  while (space > AX25_RADIO_SYMBOL_LENGTH) {
-    bool b = READ_BIT1(m_poBuffer, m_poPtr) != 0U;
-    m_poPtr++;
+  while (space > 0U) {
+    // The packets following on from the first one start and end part way through the bit buffer
+    m_tokens.update(m_poBase + m_poPtr);
+
+    q15_t buffer[TX_BLOCK_LENGTH];
+    uint16_t length = (space < TX_BLOCK_LENGTH) ? space : TX_BLOCK_LENGTH;
 
-    writeBit(b);
+    bool end = writeSamples(buffer, length);
+    if (length > 0U)
+      io.write(buffer, length);
 
-    space -= AX25_RADIO_SYMBOL_LENGTH;
+    space -= length;
 
-    if (m_poPtr >= m_poLen) {
-      m_poPtr = 0U;
-      m_poLen = 0U;
+    if (end) {
+      m_tokens.update(m_poBase + m_poLen);
+
+      m_poBase += m_poLen;
+      m_poPtr   = 0U;
+      m_poLen   = 0U;
       return;
     }
   }
 }
 
+void CAX25TX::flushTokens()
+{
+  m_tokens.flush();
+}
+
 uint8_t CAX25TX::writeData(const uint8_t* data, uint16_t length)
 {
+  if ((m_mode == AX25_IL2P_MODE) && (m_il2p.getMaxLength(length) > m_il2pBuffer.getSpace())) {
+    LOG_MODE1_ERROR("AX25TX: no space for the IL2P frame");
+    return 5U;
+  }
+
   CAX25Frame frame(data, length);
   frame.addCRC();
 
-  m_poLen    = 0U;
-  m_poPtr    = 0U;
-  m_nrzi     = false;
-  m_tablePtr = 0U;
+  // An FX.25 codeword carries the whole frame with its flags, and is sent without bit stuffing
+  uint8_t fx25[FX25_MAX_LENGTH];
+  uint16_t fx25Length = 0U;
+  bool useFX25 = (m_mode != AX25_IL2P_MODE) && m_fx25.process(frame, fx25, fx25Length);
+
+  // The bits sent after the TX delay, allowing for a stuffed bit after every five HDLC bits
+  uint16_t bits = 0U;
+  if (m_mode == AX25_IL2P_MODE)
+    bits = 24U + (m_il2p.getMaxLength(length) * 8U) + 8U;
+  else if (useFX25)
+    bits = fx25Length * 8U;
+  else
+    bits = 8U + (frame.m_length * 8U) + ((frame.m_length * 8U) / AX25_MAX_ONES) + 8U;
+
+  // A packet that arrives while another is waiting or being sent follows straight on from it, only a new
+  // transmission starts with the TX delay
+  bool follow = m_poLen > 0U;
+  uint16_t txDelay = follow ? 0U : m_txDelay;
+
+  const uint32_t maxBits = sizeof(m_poBuffer) * 8U;
+
+  // The bytes that have been sent are removed to make room, leaving the last bit sent so that the
+  // transmission is still seen as started
+  if (follow && (m_poPtr > 0U) && (uint32_t(m_poLen + bits) > maxBits)) {
+    uint16_t sent = (m_poPtr - 1U) / 8U;
+    ::memmove(m_poBuffer, m_poBuffer + sent, ((m_poLen + 7U) / 8U) - sent);
+    m_poBase += sent * 8U;
+    m_poPtr  -= sent * 8U;
+    m_poLen  -= sent * 8U;
+  }
+
+  if (uint32_t(m_poLen + txDelay + bits) > maxBits) {
+    LOG_MODE1_ERROR("AX25TX: no space for the frame", m_poLen + txDelay + bits);
+    return 5U;
+  }
+
+  if (!follow) {
+    m_poPtr    = 0U;
+    m_nrzi     = false;
+    m_phase    = 0U;
+    m_bitClock = 0U;
+  }
+
+  m_poStart = m_poBase + m_poLen;
 
   // Add TX delay
-  for (uint16_t i = 0U; i < m_txDelay; i++, m_poLen++) {
+  for (uint16_t i = 0U; i < txDelay; i++, m_poLen++) {
     bool preamble = NRZI(false);
     WRITE_BIT1(m_poBuffer, m_poLen, preamble);
   }
 
+  if (m_mode == AX25_IL2P_MODE) {
+    // The IL2P sync word and frame are sent MSB first, without NRZI or bit stuffing
+    for (uint8_t i = 0U; i < 24U; i++, m_poLen++)
+      WRITE_BIT1(m_poBuffer, m_poLen, ((AX25_IL2P_SYNC << i) & 0x800000U) == 0x800000U);
+
+    m_il2p.process(data, length, m_il2pBuffer);
+
+    uint8_t c = 0U;
+    while (m_il2pBuffer.get(c)) {
+      for (uint8_t i = 0U; i < 8U; i++, m_poLen++, c <<= 1)
+        WRITE_BIT1(m_poBuffer, m_poLen, (c & 0x80U) == 0x80U);
+    }
+
+    // A short postamble lets the receiver clock out the last bits
+    for (uint8_t i = 0U; i < 8U; i++, m_poLen++)
+      WRITE_BIT1(m_poBuffer, m_poLen, (i & 0x01U) == 0x01U);
+
+    return 0U;
+  }
+
+  if (useFX25) {
+    for (uint16_t i = 0U; i < (fx25Length * 8U); i++, m_poLen++) {
+      bool b1 = READ_BIT2(fx25, i) != 0U;
+      bool b2 = NRZI(b1);
+      WRITE_BIT1(m_poBuffer, m_poLen, b2);
+    }
+
+    return 0U;
+  }
+
   // Add the Start Flag
   for (uint16_t i = 0U; i < 8U; i++, m_poLen++) {
     bool b1 = READ_BIT1(START_FLAG, i) != 0U;
@@ -160,33 +269,63 @@ uint8_t CAX25TX::writeData(const uint8_t* data, uint16_t length)
 
 uint8_t CAX25TX::writeDataAck(uint16_t token, const uint8_t* data, uint16_t length)
 {
-  m_tokens.push_back(token);
+  if (!m_tokens.hasSpace()) {
+    LOG_MODE1_ERROR("AX25TX: no space for the token");
+    return 5U;
+  }
+
+  uint8_t ret = writeData(data, length);
+  if (ret != 0U)
+    return ret;
+
+  // The packet runs from its preamble, if it has one, to the end of the bit buffer
+  m_tokens.add(token, m_poStart, m_poBase + m_poLen);
 
-  return writeData(data, length);
+  return 0U;
 }
 
-void CAX25TX::writeBit(bool b)
+bool CAX25TX::writeSamples(q15_t* buffer, uint16_t& length)
 {
-  q15_t buffer[AX25_RADIO_SYMBOL_LENGTH];
-  for (uint8_t i = 0U; i < AX25_RADIO_SYMBOL_LENGTH; i++) {
-    q15_t value = AUDIO_TABLE_DATA[m_tablePtr];
-
-    if (b) {
-      // De-emphasise the lower frequency by 6dB
-      value >>= 2;
-      m_tablePtr += 6U;
-    } else {
-      m_tablePtr += 11U;
+  // The bit clock holds the remaining time of the current bit in units of 1/(bit rate x sample rate), so a bit
+  // need not be a whole number of samples long
+  for (uint16_t i = 0U; i < length; i++) {
+    if (m_bitClock < AX25_BIT_RATE) {
+      if (m_poPtr >= m_poLen) {
+        length = i;
+        return true;
+      }
+
+      m_bit = READ_BIT1(m_poBuffer, m_poPtr) != 0U;
+      m_poPtr++;
+
+      m_bitClock += AX25_SAMPLE_RATE;
     }
 
-    q31_t res = (value >> 1) * m_level;
+    m_bitClock -= AX25_BIT_RATE;
+
+    q31_t res = (sine(m_phase) >> 4) * (m_bit ? m_markLevel : m_spaceLevel);
     buffer[i] = q15_t(__SSAT((res >> 15), 16));
 
-    if (m_tablePtr >= AUDIO_TABLE_LEN)
-      m_tablePtr -= AUDIO_TABLE_LEN;
+    m_phase += m_bit ? MARK_INCREMENT : SPACE_INCREMENT;
   }
 
-  io.write(buffer, AX25_RADIO_SYMBOL_LENGTH);
+  return (m_bitClock < AX25_BIT_RATE) && (m_poPtr >= m_poLen);
+}
+
+q15_t CAX25TX::sine(uint32_t phase) const
+{
+  uint16_t index = (phase >> 22) & 0xFFU;
+
+  switch (phase >> 30) {
+    case 0U:
+      return SINE_TABLE[index];
+    case 1U:
+      return SINE_TABLE[256U - index];
+    case 2U:
+      return -SINE_TABLE[index];
+    default:
+      return -SINE_TABLE[256U - index];
+  }
 }
 
 void CAX25TX::setTXDelay(uint8_t value)
@@ -197,6 +336,28 @@ void CAX25TX::setTXDelay(uint8_t value)
 void CAX25TX::setLevel(uint8_t value)
 {
   m_level = q15_t(value * 128);
+
+  setLevels();
+}
+
+void CAX25TX::setLevels()
+{
+  uint8_t preemphasis = MODE1_TX_PREEMPHASIS;
+  if (preemphasis > 12U)
+    preemphasis = 12U;
+
+  m_markLevel  = q15_t((q31_t(m_level) * PREEMPHASIS_TABLE[preemphasis]) >> 15);
+  m_spaceLevel = m_level;
+}
+
+void CAX25TX::setFX25(uint8_t value)
+{
+  m_fx25.setCheckBytes(value);
+}
+
+void CAX25TX::setIL2PMaxFEC(bool on)
+{
+  m_il2p.setMaxFEC(on);
 }
 
 bool CAX25TX::NRZI(bool b)
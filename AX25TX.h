@@ -21,7 +21,10 @@
 #if !defined(AX25TX_H)
 #define  AX25TX_H
 
-#include <vector>
+#include "FX25TX.h"
+#include "IL2PTX.h"
+#include "RingBuffer.h"
+#include "TokenStore.h"
 
 class CAX25TX {
 public:
@@ -32,20 +35,35 @@ public:
 
   void process();
 
+  void flushTokens();
+
   void setTXDelay(uint8_t value);
   void setLevel(uint8_t value);
+  void setFX25(uint8_t value);
+  void setIL2PMaxFEC(bool on);
 
 private:
-  uint8_t    m_poBuffer[600U];
+  uint8_t    m_poBuffer[750U];
   uint16_t   m_poLen;
   uint16_t   m_poPtr;
-  uint16_t   m_tablePtr;
+  uint32_t   m_poBase;
+  uint32_t   m_poStart;
+  uint32_t   m_phase;
+  uint16_t   m_bitClock;
+  bool       m_bit;
   bool       m_nrzi;
   q15_t      m_level;
+  q15_t      m_markLevel;
+  q15_t      m_spaceLevel;
   uint16_t   m_txDelay;
-  std::vector<uint16_t> m_tokens;
+  CFX25TX    m_fx25;
+  CIL2PTX    m_il2p;
+  CRingBuffer<uint8_t> m_il2pBuffer;
+  CTokenStore m_tokens;
 
-  void writeBit(bool b);
+  bool writeSamples(q15_t* buffer, uint16_t& length);
+  q15_t sine(uint32_t phase) const;
+  void setLevels();
   bool NRZI(bool b);
 };
 
@@ -38,11 +38,38 @@
 // Baud rate for host communication.
 #define SERIAL_SPEED	115200
 
+// Use DMA for the host serial port, comment out to use an interrupt for every byte
+#define	SERIAL_DMA
+
+// When the queue of received frames for the host is full, 1 drops the oldest frame and 0 the newest
+#define	RX_QUEUE_DROP_OLDEST	1
+
 // Select the initial packet mode
 // 1 = 1200 bps AFSK AX.25
 // 2 = 9600 bps C4FSK IL2P
+// 3 = 9600 bps G3RUH FSK AX.25
+// 4 = 19200 bps C4FSK IL2P
+// 5 = 1200 bps AFSK IL2P
 #define	INITIAL_MODE	2
 
+// Select FX.25 for transmitting in mode 1, the number of RS check bytes
+// 0 = Plain AX.25, 16 = RS(255,239), 32 = RS(255,223), 64 = RS(255,191)
+#define	MODE1_FX25	0
+
+// Mode 1 and 5 transmit pre-emphasis, the 1200 Hz tone is sent this many dB below the 2200 Hz tone, 0 to 12
+#define	MODE1_TX_PREEMPHASIS	12
+
+// Select the IL2P FEC level used for transmitting in modes 2, 4, and 5
+// 0 = Baseline FEC, 2 to 8 parity bytes per block depending on the block size
+// 1 = Max FEC, 16 parity bytes per block
+#define	MODE2_MAX_FEC	1
+
+// Mode 2 burst window in milliseconds, a packet queued within this time of the
+// previous one is sent in the same transmission after just a sync vector, 0 to disable.
+// Every station on the channel must be running firmware that decodes a packet straight
+// after the CRC of the one before it, earlier firmware loses the packets that follow.
+#define	MODE2_BURST_WINDOW	0
+
 // TX Delay in milliseconds
 #define	TX_DELAY	300
 
@@ -58,12 +85,23 @@
 // Set Duplex, 1 for full duplex, 0 for simplex
 #define	DUPLEX		0
 
-// Select use of serial debugging
+// Select use of serial debugging, the binary events are decoded with Tools/DebugDecoder
 #define	SERIAL_DEBUGGING
 
 // Baud rate for serial debugging.
 #define DEBUGGING_SPEED	38400
 
+// The highest level of debug messages built in for each subsystem, 0 for none, 1 for errors, 2 for information
+// and 3 for tracing. Levels that are built in may be switched on and off from the host.
+#define	LOG_LEVEL_GENERAL	3
+#define	LOG_LEVEL_MODE1		3
+#define	LOG_LEVEL_IL2P		3
+#define	LOG_LEVEL_MODE2		3
+#define	LOG_LEVEL_MODE3		3
+
+// The level of debug messages sent for each subsystem at start up
+#define	LOG_LEVEL_STARTUP	2
+
 // Set the receive level (out of 255)
 #define	RX_LEVEL	128
 
@@ -73,6 +111,9 @@
 // Set the mode 2 transmit level (out of 255)
 #define	MODE2_TX_LEVEL	128
 
+// Set the mode 3 transmit level (out of 255)
+#define	MODE3_TX_LEVEL	128
+
 // Set the KISS TNC address, default is 0
 #define	KISS_ADDRESS	0
 
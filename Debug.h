@@ -22,12 +22,112 @@
 #include "Config.h"
 #include "Globals.h"
 
-#define  DEBUG1(a)            serial.writeDebug((a))
-#define  DEBUG2(a,b)          serial.writeDebug((a),(b))
-#define  DEBUG3(a,b,c)        serial.writeDebug((a),(b),(c))
-#define  DEBUG4(a,b,c,d)      serial.writeDebug((a),(b),(c),(d))
-#define  DEBUG5(a,b,c,d,e)    serial.writeDebug((a),(b),(c),(d),(e))
-#define  DEBUG6(a,b,c,d,e,f)  serial.writeDebug((a),(b),(c),(d),(e),(f))
+#if !defined(LOG_LEVEL_GENERAL)
+#define  LOG_LEVEL_GENERAL       LOGL_TRACE
+#endif
+#if !defined(LOG_LEVEL_MODE1)
+#define  LOG_LEVEL_MODE1         LOGL_TRACE
+#endif
+#if !defined(LOG_LEVEL_IL2P)
+#define  LOG_LEVEL_IL2P          LOGL_TRACE
+#endif
+#if !defined(LOG_LEVEL_MODE2)
+#define  LOG_LEVEL_MODE2         LOGL_TRACE
+#endif
+#if !defined(LOG_LEVEL_MODE3)
+#define  LOG_LEVEL_MODE3         LOGL_TRACE
+#endif
+
+// Messages above the level built in for their subsystem are removed by the preprocessor, the rest are checked
+// against the level set at run time.
+#if defined(SERIAL_DEBUGGING)
+#define  LOG_WRITE(s,l,...)      do { if (serial.isLogging((s),(l))) serial.writeDebug(__VA_ARGS__); } while (false)
+#else
+#define  LOG_WRITE(s,l,...)      do { } while (false)
+#endif
+
+#define  LOG_NONE(...)           do { } while (false)
+
+#if LOG_LEVEL_GENERAL >= LOGL_ERROR
+#define  LOG_GENERAL_ERROR(...)  LOG_WRITE(LOGS_GENERAL, LOGL_ERROR, __VA_ARGS__)
+#else
+#define  LOG_GENERAL_ERROR(...)  LOG_NONE()
+#endif
+#if LOG_LEVEL_GENERAL >= LOGL_INFO
+#define  LOG_GENERAL_INFO(...)   LOG_WRITE(LOGS_GENERAL, LOGL_INFO, __VA_ARGS__)
+#else
+#define  LOG_GENERAL_INFO(...)   LOG_NONE()
+#endif
+#if LOG_LEVEL_GENERAL >= LOGL_TRACE
+#define  LOG_GENERAL_TRACE(...)  LOG_WRITE(LOGS_GENERAL, LOGL_TRACE, __VA_ARGS__)
+#else
+#define  LOG_GENERAL_TRACE(...)  LOG_NONE()
+#endif
+
+#if LOG_LEVEL_MODE1 >= LOGL_ERROR
+#define  LOG_MODE1_ERROR(...)    LOG_WRITE(LOGS_MODE1, LOGL_ERROR, __VA_ARGS__)
+#else
+#define  LOG_MODE1_ERROR(...)    LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE1 >= LOGL_INFO
+#define  LOG_MODE1_INFO(...)     LOG_WRITE(LOGS_MODE1, LOGL_INFO, __VA_ARGS__)
+#else
+#define  LOG_MODE1_INFO(...)     LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE1 >= LOGL_TRACE
+#define  LOG_MODE1_TRACE(...)    LOG_WRITE(LOGS_MODE1, LOGL_TRACE, __VA_ARGS__)
+#else
+#define  LOG_MODE1_TRACE(...)    LOG_NONE()
+#endif
+
+#if LOG_LEVEL_IL2P >= LOGL_ERROR
+#define  LOG_IL2P_ERROR(...)     LOG_WRITE(LOGS_IL2P, LOGL_ERROR, __VA_ARGS__)
+#else
+#define  LOG_IL2P_ERROR(...)     LOG_NONE()
+#endif
+#if LOG_LEVEL_IL2P >= LOGL_INFO
+#define  LOG_IL2P_INFO(...)      LOG_WRITE(LOGS_IL2P, LOGL_INFO, __VA_ARGS__)
+#else
+#define  LOG_IL2P_INFO(...)      LOG_NONE()
+#endif
+#if LOG_LEVEL_IL2P >= LOGL_TRACE
+#define  LOG_IL2P_TRACE(...)     LOG_WRITE(LOGS_IL2P, LOGL_TRACE, __VA_ARGS__)
+#else
+#define  LOG_IL2P_TRACE(...)     LOG_NONE()
+#endif
+
+#if LOG_LEVEL_MODE2 >= LOGL_ERROR
+#define  LOG_MODE2_ERROR(...)    LOG_WRITE(LOGS_MODE2, LOGL_ERROR, __VA_ARGS__)
+#else
+#define  LOG_MODE2_ERROR(...)    LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE2 >= LOGL_INFO
+#define  LOG_MODE2_INFO(...)     LOG_WRITE(LOGS_MODE2, LOGL_INFO, __VA_ARGS__)
+#else
+#define  LOG_MODE2_INFO(...)     LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE2 >= LOGL_TRACE
+#define  LOG_MODE2_TRACE(...)    LOG_WRITE(LOGS_MODE2, LOGL_TRACE, __VA_ARGS__)
+#else
+#define  LOG_MODE2_TRACE(...)    LOG_NONE()
+#endif
+
+#if LOG_LEVEL_MODE3 >= LOGL_ERROR
+#define  LOG_MODE3_ERROR(...)    LOG_WRITE(LOGS_MODE3, LOGL_ERROR, __VA_ARGS__)
+#else
+#define  LOG_MODE3_ERROR(...)    LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE3 >= LOGL_INFO
+#define  LOG_MODE3_INFO(...)     LOG_WRITE(LOGS_MODE3, LOGL_INFO, __VA_ARGS__)
+#else
+#define  LOG_MODE3_INFO(...)     LOG_NONE()
+#endif
+#if LOG_LEVEL_MODE3 >= LOGL_TRACE
+#define  LOG_MODE3_TRACE(...)    LOG_WRITE(LOGS_MODE3, LOGL_TRACE, __VA_ARGS__)
+#else
+#define  LOG_MODE3_TRACE(...)    LOG_NONE()
+#endif
+
 #define  DEBUG_DUMP(a,b)      serial.writeDebugDump((a),(b))
 
 #endif
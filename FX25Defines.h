@@ -0,0 +1,42 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(FX25DEFINES_H)
+#define  FX25DEFINES_H
+
+#include <cstdint>
+
+const uint16_t FX25_BLOCK_LENGTH = 255U;          // Only the full length codes are used
+const uint8_t  FX25_TAG_LENGTH   = 8U;
+
+const uint8_t  FX25_MAX_TAG_ERRS = 8U;
+
+struct FX25_MODE {
+  uint64_t tag;                                   // Sent least significant bit first
+  uint8_t  checkBytes;
+};
+
+const uint8_t FX25_MODE_COUNT = 3U;
+
+const FX25_MODE FX25_MODES[] = {
+  {0xB74DB7DF8A532F3EULL, 16U},                   // Tag 01, RS(255,239)
+  {0x6E260B1AC5835FAEULL, 32U},                   // Tag 05, RS(255,223)
+  {0x3ADB0C13DEAE2836ULL, 64U}};                  // Tag 09, RS(255,191)
+
+#endif
+
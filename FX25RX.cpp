@@ -0,0 +1,128 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "Globals.h"
+#include "FX25RX.h"
+#include "Utils.h"
+
+const uint8_t NO_MODE = 99U;
+
+const uint8_t BIT_MASK_TABLE2[] = { 0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U };
+
+#define WRITE_BIT2(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE2[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE2[(i)&7])
+#define READ_BIT2(p,i)    (p[(i)>>3] & BIT_MASK_TABLE2[(i)&7])
+
+CFX25RX::CFX25RX() :
+m_tag(0U),
+m_mode(NO_MODE),
+m_block(),
+m_bits(0U),
+m_start(0U),
+m_hdlc(),
+m_rs16(16U, 1U),
+m_rs32(32U, 1U),
+m_rs64(64U, 1U)
+{
+}
+
+bool CFX25RX::process(bool b, CAX25Frame& frame)
+{
+  if (m_mode == NO_MODE) {
+    // The tag is sent least significant bit first
+    m_tag >>= 1;
+    if (b)
+      m_tag |= 0x8000000000000000ULL;
+
+    for (uint8_t i = 0U; i < FX25_MODE_COUNT; i++) {
+      if (countBits64(m_tag ^ FX25_MODES[i].tag) <= FX25_MAX_TAG_ERRS) {
+        LOG_MODE1_TRACE("FX25RX: found a correlation tag, check bytes", FX25_MODES[i].checkBytes);
+        m_mode  = i;
+        m_bits  = 0U;
+        m_start = io.getRXSampleIndex();
+        return false;
+      }
+    }
+
+    return false;
+  }
+
+  WRITE_BIT2(m_block, m_bits, b);
+  m_bits++;
+
+  if (m_bits < (FX25_BLOCK_LENGTH * 8U))
+    return false;
+
+  bool ok = decode(frame);
+
+  m_mode = NO_MODE;
+  m_tag  = 0U;
+
+  return ok;
+}
+
+bool CFX25RX::isBusy() const
+{
+  return m_mode != NO_MODE;
+}
+
+bool CFX25RX::decode(CAX25Frame& frame)
+{
+  uint8_t errlocs[64U];
+
+  int errors = 0;
+  switch (FX25_MODES[m_mode].checkBytes) {
+    case 16U:
+      errors = m_rs16.decode(m_block, errlocs);
+      break;
+    case 32U:
+      errors = m_rs32.decode(m_block, errlocs);
+      break;
+    default:
+      errors = m_rs64.decode(m_block, errlocs);
+      break;
+  }
+
+  if (errors < 0) {
+    LOG_MODE1_INFO("FX25RX: codeword is uncorrectable");
+    stats.increment(STATS_RS_FAILED);
+    return false;
+  }
+
+  if (errors > 0)
+    stats.increment(STATS_RS_CORRECTED);
+
+  // The corrected data is an ordinary HDLC frame padded out with flags
+  m_hdlc.reset();
+
+  uint16_t dataBits = (FX25_BLOCK_LENGTH - FX25_MODES[m_mode].checkBytes) * 8U;
+  for (uint16_t i = 0U; i < dataBits; i++) {
+    bool ok = m_hdlc.process(READ_BIT2(m_block, i) != 0U, frame);
+    if (ok) {
+      LOG_MODE1_INFO("FX25RX: frame is valid, corrected bytes", errors);
+      frame.m_start = m_start;
+      return true;
+    }
+  }
+
+  LOG_MODE1_INFO("FX25RX: frame CRC is invalid");
+
+  return false;
+}
+
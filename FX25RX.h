@@ -0,0 +1,53 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(FX25RX_H)
+#define  FX25RX_H
+
+#include "FX25Defines.h"
+#include "AX25Frame.h"
+#include "AX25HDLC.h"
+#include "IL2PRS.h"
+
+class CFX25RX {
+public:
+  CFX25RX();
+
+  // Takes the NRZI decoded bits, and copies out a frame once its codeword is corrected and its CRC is valid
+  bool process(bool b, CAX25Frame& frame);
+
+  bool isBusy() const;
+
+private:
+  uint64_t  m_tag;
+  uint8_t   m_mode;
+  uint8_t   m_block[FX25_BLOCK_LENGTH];
+  uint16_t  m_bits;
+  uint32_t  m_start;
+  CAX25HDLC m_hdlc;
+  CIL2PRS   m_rs16;
+  CIL2PRS   m_rs32;
+  CIL2PRS   m_rs64;
+
+  bool decode(CAX25Frame& frame);
+};
+
+#endif
+
@@ -0,0 +1,115 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "Globals.h"
+#include "FX25TX.h"
+
+#include "AX25Defines.h"
+
+const uint8_t NO_MODE = 99U;
+
+const uint8_t BIT_MASK_TABLE2[] = { 0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U };
+
+#define WRITE_BIT2(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE2[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE2[(i)&7])
+#define READ_BIT2(p,i)    (p[(i)>>3] & BIT_MASK_TABLE2[(i)&7])
+
+CFX25TX::CFX25TX() :
+m_mode(NO_MODE),
+m_rs16(16U, 1U),
+m_rs32(32U, 1U),
+m_rs64(64U, 1U)
+{
+}
+
+bool CFX25TX::process(const CAX25Frame& frame, uint8_t* out, uint16_t& length) const
+{
+  if (m_mode == NO_MODE)
+    return false;
+
+  uint16_t dataLength = FX25_BLOCK_LENGTH - FX25_MODES[m_mode].checkBytes;
+  uint16_t maxBits    = dataLength * 8U;
+
+  uint8_t* block = out + FX25_TAG_LENGTH;
+
+  // The data part of the codeword is the ordinary HDLC frame, so that plain AX.25 receivers still decode it
+  uint16_t n = 0U;
+  for (uint8_t i = 0U; i < 8U; i++, n++)
+    WRITE_BIT2(block, n, (AX25_FRAME_START >> i) & 0x01U);
+
+  uint8_t ones = 0U;
+  for (uint16_t i = 0U; i < (frame.m_length * 8U); i++) {
+    // Leave room for the end flag
+    if ((n + 8U + 1U) >= maxBits) {
+      LOG_MODE1_ERROR("FX25TX: frame is too long for FX.25", frame.m_length);
+      return false;
+    }
+
+    bool b = READ_BIT2(frame.m_data, i) != 0U;
+    WRITE_BIT2(block, n, b);
+    n++;
+
+    if (b) {
+      ones++;
+      if (ones == AX25_MAX_ONES) {
+        // Bit stuffing
+        WRITE_BIT2(block, n, false);
+        n++;
+        ones = 0U;
+      }
+    } else {
+      ones = 0U;
+    }
+  }
+
+  // The end flag, followed by more flags to fill the block
+  for (uint8_t i = 0U; n < maxBits; i = (i + 1U) & 0x07U, n++)
+    WRITE_BIT2(block, n, (AX25_FRAME_END >> i) & 0x01U);
+
+  switch (FX25_MODES[m_mode].checkBytes) {
+    case 16U:
+      m_rs16.encode(block, block + dataLength);
+      break;
+    case 32U:
+      m_rs32.encode(block, block + dataLength);
+      break;
+    default:
+      m_rs64.encode(block, block + dataLength);
+      break;
+  }
+
+  uint64_t tag = FX25_MODES[m_mode].tag;
+  for (uint8_t i = 0U; i < FX25_TAG_LENGTH; i++, tag >>= 8)
+    out[i] = uint8_t(tag);
+
+  length = FX25_MAX_LENGTH;
+
+  return true;
+}
+
+void CFX25TX::setCheckBytes(uint8_t value)
+{
+  m_mode = NO_MODE;
+
+  for (uint8_t i = 0U; i < FX25_MODE_COUNT; i++) {
+    if (FX25_MODES[i].checkBytes == value)
+      m_mode = i;
+  }
+}
+
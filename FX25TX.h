@@ -0,0 +1,47 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(FX25TX_H)
+#define  FX25TX_H
+
+#include "FX25Defines.h"
+#include "AX25Frame.h"
+#include "IL2PRS.h"
+
+const uint16_t FX25_MAX_LENGTH = FX25_TAG_LENGTH + FX25_BLOCK_LENGTH;
+
+class CFX25TX {
+public:
+  CFX25TX();
+
+  // The output is sent least significant bit first, without any bit stuffing
+  bool process(const CAX25Frame& frame, uint8_t* out, uint16_t& length) const;
+
+  void setCheckBytes(uint8_t value);
+
+private:
+  uint8_t  m_mode;
+  CIL2PRS  m_rs16;
+  CIL2PRS  m_rs32;
+  CIL2PRS  m_rs64;
+};
+
+#endif
+
@@ -42,6 +42,9 @@
 #include "AX25TX.h"
 #include "Mode2RX.h"
 #include "Mode2TX.h"
+#include "Mode3RX.h"
+#include "Mode3TX.h"
+#include "Statistics.h"
 #include "Debug.h"
 #include "IO.h"
 
@@ -60,11 +63,16 @@ extern bool m_tx;
 extern CSerialPort serial;
 extern CIO io;
 
+extern CStatistics stats;
+
 extern CAX25RX ax25RX;
 extern CAX25TX ax25TX;
 
 extern CMode2TX mode2TX;
 extern CMode2RX mode2RX;
 
+extern CMode3TX mode3TX;
+extern CMode3RX mode3RX;
+
 #endif
 
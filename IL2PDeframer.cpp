@@ -0,0 +1,161 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "Globals.h"
+#include "IL2PDeframer.h"
+#include "AX25Defines.h"
+#include "Utils.h"
+
+const uint8_t HEADER_LENGTH = 15U;       // Header and its parity
+const uint8_t CRC_LENGTH    = 4U;
+
+const uint8_t MAX_SYNC_ERRS = 1U;
+
+CIL2PDeframer::CIL2PDeframer() :
+m_state(IL2PDS_NONE),
+m_sync(0U),
+m_invert(false),
+m_byte(0U),
+m_bits(0U),
+m_count(0U),
+m_length(0U),
+m_start(0U),
+m_buffer(),
+m_packet(),
+m_frame()
+{
+}
+
+bool CIL2PDeframer::process(bool b, CAX25Frame& frame)
+{
+  if (m_state == IL2PDS_NONE) {
+    m_sync = ((m_sync << 1) | (b ? 0x01U : 0x00U)) & 0xFFFFFFU;
+
+    // IL2P has no NRZI, so the sync word shows the sense of the tones
+    if (countBits32(m_sync ^ AX25_IL2P_SYNC) <= MAX_SYNC_ERRS) {
+      m_invert = false;
+      start(IL2PDS_HEADER, HEADER_LENGTH);
+    } else if (countBits32(m_sync ^ AX25_IL2P_SYNC ^ 0xFFFFFFU) <= MAX_SYNC_ERRS) {
+      m_invert = true;
+      start(IL2PDS_HEADER, HEADER_LENGTH);
+    }
+
+    return false;
+  }
+
+  m_byte = (m_byte << 1) | ((b != m_invert) ? 0x01U : 0x00U);
+  m_bits++;
+
+  if (m_bits < 8U)
+    return false;
+
+  m_buffer[m_count++] = m_byte;
+  m_byte = 0U;
+  m_bits = 0U;
+
+  if (m_count < m_length)
+    return false;
+
+  return processBlock(frame);
+}
+
+bool CIL2PDeframer::isBusy() const
+{
+  return m_state != IL2PDS_NONE;
+}
+
+bool CIL2PDeframer::processBlock(CAX25Frame& frame)
+{
+  switch (m_state) {
+    case IL2PDS_HEADER: {
+        bool ok = m_frame.processHeader(m_buffer, m_packet);
+        if (!ok) {
+          LOG_IL2P_TRACE("IL2PDeframer: header is invalid");
+          stats.increment(STATS_SYNC_FALSE);
+          m_state = IL2PDS_NONE;
+          return false;
+        }
+
+        uint16_t length = m_frame.getHeaderLength() + m_frame.getPayloadLength();
+        if (length > (AX25_MAX_PACKET_LEN - 2U)) {
+          LOG_IL2P_INFO("IL2PDeframer: frame is too long", length);
+          m_state = IL2PDS_NONE;
+          return false;
+        }
+
+        if (m_frame.getPayloadLength() > 0U)
+          start(IL2PDS_PAYLOAD, m_frame.getPayloadLength() + m_frame.getPayloadParityLength());
+        else
+          start(IL2PDS_CRC, CRC_LENGTH);
+      }
+      return false;
+
+    case IL2PDS_PAYLOAD: {
+        bool ok = m_frame.processPayload(m_buffer, m_packet);
+        if (!ok) {
+          LOG_IL2P_INFO("IL2PDeframer: payload is invalid");
+          m_state = IL2PDS_NONE;
+          return false;
+        }
+
+        start(IL2PDS_CRC, CRC_LENGTH);
+      }
+      return false;
+
+    case IL2PDS_CRC: {
+        m_state = IL2PDS_NONE;
+
+        bool ok = m_frame.checkCRC(m_packet, m_buffer);
+        if (!ok) {
+          LOG_IL2P_INFO("IL2PDeframer: frame CRC is invalid");
+          stats.increment(STATS_IL2P_CRC_ERRORS);
+          return false;
+        }
+
+        // Add the AX.25 FCS so that the frame looks the same as one decoded from HDLC
+        frame.m_length = m_frame.getHeaderLength() + m_frame.getPayloadLength();
+        ::memcpy(frame.m_data, m_packet, frame.m_length);
+        frame.addCRC();
+        frame.m_start = m_start;
+
+        LOG_IL2P_INFO("IL2PDeframer: frame is valid", frame.m_length);
+      }
+      return true;
+
+    default:
+      m_state = IL2PDS_NONE;
+      return false;
+  }
+}
+
+void CIL2PDeframer::start(IL2PDEFRAMER_STATE state, uint16_t length)
+{
+  m_state  = state;
+  m_sync   = 0U;
+  m_length = length;
+  m_count  = 0U;
+  m_byte   = 0U;
+  m_bits   = 0U;
+
+  // The header follows straight on from the sync
+  if (state == IL2PDS_HEADER)
+    m_start = io.getRXSampleIndex();
+}
+
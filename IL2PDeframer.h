@@ -0,0 +1,61 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(IL2PDEFRAMER_H)
+#define  IL2PDEFRAMER_H
+
+#include "AX25Frame.h"
+#include "IL2PRX.h"
+
+enum IL2PDEFRAMER_STATE {
+  IL2PDS_NONE,
+  IL2PDS_HEADER,
+  IL2PDS_PAYLOAD,
+  IL2PDS_CRC
+};
+
+class CIL2PDeframer {
+public:
+  CIL2PDeframer();
+
+  // Takes the raw bits, and copies out a frame with an FCS added once its IL2P CRC is valid
+  bool process(bool b, CAX25Frame& frame);
+
+  bool isBusy() const;
+
+private:
+  IL2PDEFRAMER_STATE m_state;
+  uint32_t           m_sync;
+  bool               m_invert;
+  uint8_t            m_byte;
+  uint8_t            m_bits;
+  uint16_t           m_count;
+  uint16_t           m_length;
+  uint32_t           m_start;
+  uint8_t            m_buffer[AX25_MAX_PACKET_LEN + 32U];    // The payload of the largest frame with its parity
+  uint8_t            m_packet[AX25_MAX_PACKET_LEN + 16U];    // Plus the parity of a block while it is corrected
+  CIL2PRX            m_frame;
+
+  bool processBlock(CAX25Frame& frame);
+  void start(IL2PDEFRAMER_STATE state, uint16_t length);
+};
+
+#endif
+
@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2023 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -24,7 +24,8 @@
 
 #include <cstring>
 
-const uint8_t ALPHA_TO_2[] = {
+// The GF(256) tables are common to all of the codes, only the generator polynomial differs
+const uint8_t RS_ALPHA_TO[] = {
   0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U, 0x1DU, 0x3AU, 0x74U, 0xE8U, 0xCDU, 0x87U, 0x13U, 0x26U,
   0x4CU, 0x98U, 0x2DU, 0x5AU, 0xB4U, 0x75U, 0xEAU, 0xC9U, 0x8FU, 0x03U, 0x06U, 0x0CU, 0x18U, 0x30U, 0x60U, 0xC0U,
   0x9DU, 0x27U, 0x4EU, 0x9CU, 0x25U, 0x4AU, 0x94U, 0x35U, 0x6AU, 0xD4U, 0xB5U, 0x77U, 0xEEU, 0xC1U, 0x9FU, 0x23U,
@@ -41,7 +42,7 @@ const uint8_t ALPHA_TO_2[] = {
   0x51U, 0xA2U, 0x59U, 0xB2U, 0x79U, 0xF2U, 0xF9U, 0xEFU, 0xC3U, 0x9BU, 0x2BU, 0x56U, 0xACU, 0x45U, 0x8AU, 0x09U,
   0x12U, 0x24U, 0x48U, 0x90U, 0x3DU, 0x7AU, 0xF4U, 0xF5U, 0xF7U, 0xF3U, 0xFBU, 0xEBU, 0xCBU, 0x8BU, 0x0BU, 0x16U,
   0x2CU, 0x58U, 0xB0U, 0x7DU, 0xFAU, 0xE9U, 0xCFU, 0x83U, 0x1BU, 0x36U, 0x6CU, 0xD8U, 0xADU, 0x47U, 0x8EU, 0x00U};
-const uint8_t INDEX_OF_2[] = {
+const uint8_t RS_INDEX_OF[] = {
   0xFFU, 0x00U, 0x01U, 0x19U, 0x02U, 0x32U, 0x1AU, 0xC6U, 0x03U, 0xDFU, 0x33U, 0xEEU, 0x1BU, 0x68U, 0xC7U, 0x4BU,
   0x04U, 0x64U, 0xE0U, 0x0EU, 0x34U, 0x8DU, 0xEFU, 0x81U, 0x1CU, 0xC1U, 0x69U, 0xF8U, 0xC8U, 0x08U, 0x4CU, 0x71U,
   0x05U, 0x8AU, 0x65U, 0x2FU, 0xE1U, 0x24U, 0x0FU, 0x21U, 0x35U, 0x93U, 0x8EU, 0xDAU, 0xF0U, 0x12U, 0x82U, 0x45U,
@@ -61,51 +62,42 @@ const uint8_t INDEX_OF_2[] = {
 const uint8_t GENPOLY_2[] = {
   0x01U, 0x19U, 0x00U};
 
-const uint8_t ALPHA_TO_16[] = {
-  0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U, 0x1DU, 0x3AU, 0x74U, 0xE8U, 0xCDU, 0x87U, 0x13U, 0x26U,
-  0x4CU, 0x98U, 0x2DU, 0x5AU, 0xB4U, 0x75U, 0xEAU, 0xC9U, 0x8FU, 0x03U, 0x06U, 0x0CU, 0x18U, 0x30U, 0x60U, 0xC0U,
-  0x9DU, 0x27U, 0x4EU, 0x9CU, 0x25U, 0x4AU, 0x94U, 0x35U, 0x6AU, 0xD4U, 0xB5U, 0x77U, 0xEEU, 0xC1U, 0x9FU, 0x23U,
-  0x46U, 0x8CU, 0x05U, 0x0AU, 0x14U, 0x28U, 0x50U, 0xA0U, 0x5DU, 0xBAU, 0x69U, 0xD2U, 0xB9U, 0x6FU, 0xDEU, 0xA1U,
-  0x5FU, 0xBEU, 0x61U, 0xC2U, 0x99U, 0x2FU, 0x5EU, 0xBCU, 0x65U, 0xCAU, 0x89U, 0x0FU, 0x1EU, 0x3CU, 0x78U, 0xF0U,
-  0xFDU, 0xE7U, 0xD3U, 0xBBU, 0x6BU, 0xD6U, 0xB1U, 0x7FU, 0xFEU, 0xE1U, 0xDFU, 0xA3U, 0x5BU, 0xB6U, 0x71U, 0xE2U,
-  0xD9U, 0xAFU, 0x43U, 0x86U, 0x11U, 0x22U, 0x44U, 0x88U, 0x0DU, 0x1AU, 0x34U, 0x68U, 0xD0U, 0xBDU, 0x67U, 0xCEU,
-  0x81U, 0x1FU, 0x3EU, 0x7CU, 0xF8U, 0xEDU, 0xC7U, 0x93U, 0x3BU, 0x76U, 0xECU, 0xC5U, 0x97U, 0x33U, 0x66U, 0xCCU,
-  0x85U, 0x17U, 0x2EU, 0x5CU, 0xB8U, 0x6DU, 0xDAU, 0xA9U, 0x4FU, 0x9EU, 0x21U, 0x42U, 0x84U, 0x15U, 0x2AU, 0x54U,
-  0xA8U, 0x4DU, 0x9AU, 0x29U, 0x52U, 0xA4U, 0x55U, 0xAAU, 0x49U, 0x92U, 0x39U, 0x72U, 0xE4U, 0xD5U, 0xB7U, 0x73U,
-  0xE6U, 0xD1U, 0xBFU, 0x63U, 0xC6U, 0x91U, 0x3FU, 0x7EU, 0xFCU, 0xE5U, 0xD7U, 0xB3U, 0x7BU, 0xF6U, 0xF1U, 0xFFU,
-  0xE3U, 0xDBU, 0xABU, 0x4BU, 0x96U, 0x31U, 0x62U, 0xC4U, 0x95U, 0x37U, 0x6EU, 0xDCU, 0xA5U, 0x57U, 0xAEU, 0x41U,
-  0x82U, 0x19U, 0x32U, 0x64U, 0xC8U, 0x8DU, 0x07U, 0x0EU, 0x1CU, 0x38U, 0x70U, 0xE0U, 0xDDU, 0xA7U, 0x53U, 0xA6U,
-  0x51U, 0xA2U, 0x59U, 0xB2U, 0x79U, 0xF2U, 0xF9U, 0xEFU, 0xC3U, 0x9BU, 0x2BU, 0x56U, 0xACU, 0x45U, 0x8AU, 0x09U,
-  0x12U, 0x24U, 0x48U, 0x90U, 0x3DU, 0x7AU, 0xF4U, 0xF5U, 0xF7U, 0xF3U, 0xFBU, 0xEBU, 0xCBU, 0x8BU, 0x0BU, 0x16U,
-  0x2CU, 0x58U, 0xB0U, 0x7DU, 0xFAU, 0xE9U, 0xCFU, 0x83U, 0x1BU, 0x36U, 0x6CU, 0xD8U, 0xADU, 0x47U, 0x8EU, 0x00U};
-const uint8_t INDEX_OF_16[] = {
-  0xFFU, 0x00U, 0x01U, 0x19U, 0x02U, 0x32U, 0x1AU, 0xC6U, 0x03U, 0xDFU, 0x33U, 0xEEU, 0x1BU, 0x68U, 0xC7U, 0x4BU,
-  0x04U, 0x64U, 0xE0U, 0x0EU, 0x34U, 0x8DU, 0xEFU, 0x81U, 0x1CU, 0xC1U, 0x69U, 0xF8U, 0xC8U, 0x08U, 0x4CU, 0x71U,
-  0x05U, 0x8AU, 0x65U, 0x2FU, 0xE1U, 0x24U, 0x0FU, 0x21U, 0x35U, 0x93U, 0x8EU, 0xDAU, 0xF0U, 0x12U, 0x82U, 0x45U,
-  0x1DU, 0xB5U, 0xC2U, 0x7DU, 0x6AU, 0x27U, 0xF9U, 0xB9U, 0xC9U, 0x9AU, 0x09U, 0x78U, 0x4DU, 0xE4U, 0x72U, 0xA6U,
-  0x06U, 0xBFU, 0x8BU, 0x62U, 0x66U, 0xDDU, 0x30U, 0xFDU, 0xE2U, 0x98U, 0x25U, 0xB3U, 0x10U, 0x91U, 0x22U, 0x88U,
-  0x36U, 0xD0U, 0x94U, 0xCEU, 0x8FU, 0x96U, 0xDBU, 0xBDU, 0xF1U, 0xD2U, 0x13U, 0x5CU, 0x83U, 0x38U, 0x46U, 0x40U,
-  0x1EU, 0x42U, 0xB6U, 0xA3U, 0xC3U, 0x48U, 0x7EU, 0x6EU, 0x6BU, 0x3AU, 0x28U, 0x54U, 0xFAU, 0x85U, 0xBAU, 0x3DU,
-  0xCAU, 0x5EU, 0x9BU, 0x9FU, 0x0AU, 0x15U, 0x79U, 0x2BU, 0x4EU, 0xD4U, 0xE5U, 0xACU, 0x73U, 0xF3U, 0xA7U, 0x57U,
-  0x07U, 0x70U, 0xC0U, 0xF7U, 0x8CU, 0x80U, 0x63U, 0x0DU, 0x67U, 0x4AU, 0xDEU, 0xEDU, 0x31U, 0xC5U, 0xFEU, 0x18U,
-  0xE3U, 0xA5U, 0x99U, 0x77U, 0x26U, 0xB8U, 0xB4U, 0x7CU, 0x11U, 0x44U, 0x92U, 0xD9U, 0x23U, 0x20U, 0x89U, 0x2EU,
-  0x37U, 0x3FU, 0xD1U, 0x5BU, 0x95U, 0xBCU, 0xCFU, 0xCDU, 0x90U, 0x87U, 0x97U, 0xB2U, 0xDCU, 0xFCU, 0xBEU, 0x61U,
-  0xF2U, 0x56U, 0xD3U, 0xABU, 0x14U, 0x2AU, 0x5DU, 0x9EU, 0x84U, 0x3CU, 0x39U, 0x53U, 0x47U, 0x6DU, 0x41U, 0xA2U,
-  0x1FU, 0x2DU, 0x43U, 0xD8U, 0xB7U, 0x7BU, 0xA4U, 0x76U, 0xC4U, 0x17U, 0x49U, 0xECU, 0x7FU, 0x0CU, 0x6FU, 0xF6U,
-  0x6CU, 0xA1U, 0x3BU, 0x52U, 0x29U, 0x9DU, 0x55U, 0xAAU, 0xFBU, 0x60U, 0x86U, 0xB1U, 0xBBU, 0xCCU, 0x3EU, 0x5AU,
-  0xCBU, 0x59U, 0x5FU, 0xB0U, 0x9CU, 0xA9U, 0xA0U, 0x51U, 0x0BU, 0xF5U, 0x16U, 0xEBU, 0x7AU, 0x75U, 0x2CU, 0xD7U,
-  0x4FU, 0xAEU, 0xD5U, 0xE9U, 0xE6U, 0xE7U, 0xADU, 0xE8U, 0x74U, 0xD6U, 0xF4U, 0xEAU, 0xA8U, 0x50U, 0x58U, 0xAFU};
+const uint8_t GENPOLY_4[] = {
+  0x06U, 0x4EU, 0xF9U, 0x4BU, 0x00U};
+
+const uint8_t GENPOLY_6[] = {
+  0x0FU, 0xB0U, 0x05U, 0x86U, 0x00U, 0xA6U, 0x00U};
+
+const uint8_t GENPOLY_8[] = {
+  0x1CU, 0xC4U, 0xFCU, 0xD7U, 0xF9U, 0xD0U, 0xEEU, 0xAFU, 0x00U};
+
 const uint8_t GENPOLY_16[] = {
   0x78U, 0xE1U, 0xC2U, 0xB6U, 0xA9U, 0x93U, 0xBFU, 0x5BU, 0x03U, 0x4CU, 0xA1U, 0x66U, 0x6DU, 0x6BU, 0x68U, 0x78U,
   0x00U};
 
+// The FX.25 codes have their first root at alpha^1
+const uint8_t FX25_GENPOLY_16[] = {
+  0x88U, 0xF0U, 0xD0U, 0xC3U, 0xB5U, 0x9EU, 0xC9U, 0x64U, 0x0BU, 0x53U, 0xA7U, 0x6BU, 0x71U, 0x6EU, 0x6AU, 0x79U,
+  0x00U};
+
+const uint8_t FX25_GENPOLY_32[] = {
+  0x12U, 0xFBU, 0xD7U, 0x1CU, 0x50U, 0x6BU, 0xF8U, 0x35U, 0x54U, 0xC2U, 0x5BU, 0x3BU, 0xB0U, 0x63U, 0xCBU, 0x89U,
+  0x2BU, 0x68U, 0x89U, 0x00U, 0x2CU, 0x95U, 0x94U, 0xDAU, 0x4BU, 0x0BU, 0xADU, 0xFEU, 0xC2U, 0x6DU, 0x08U, 0x0BU,
+  0x00U};
+
+const uint8_t FX25_GENPOLY_64[] = {
+  0x28U, 0x15U, 0xDAU, 0x17U, 0x30U, 0xEDU, 0x45U, 0x06U, 0x57U, 0x2AU, 0x1DU, 0xC1U, 0xA0U, 0x96U, 0x71U, 0x20U,
+  0x23U, 0xACU, 0xF1U, 0xF0U, 0xB8U, 0x5AU, 0xBCU, 0xE1U, 0x57U, 0x82U, 0xFEU, 0x29U, 0xF5U, 0xFDU, 0xB8U, 0xF1U,
+  0xBCU, 0xB0U, 0x36U, 0x3AU, 0xF0U, 0xE2U, 0x77U, 0xB9U, 0x4DU, 0x96U, 0x30U, 0x8CU, 0xA9U, 0xA0U, 0x60U, 0xD9U,
+  0x0FU, 0xCAU, 0xDAU, 0xBEU, 0x87U, 0x67U, 0x81U, 0x4DU, 0x39U, 0xA6U, 0xA4U, 0x0CU, 0x0DU, 0xB2U, 0x35U, 0x2EU,
+  0x00U};
+
 #undef MIN
 #define	MIN(a,b)	((a) < (b) ? (a) : (b))
 
 const int MM    = 8;
 const int NN    = 255;
 const int PAD   = 0;
-const int FCR   = 0;
 const int PRIM  = 1;
 const int IPRIM = 1;
 
@@ -113,6 +105,7 @@ const int IPRIM = 1;
 #define INDEX_OF (m_indexOf)
 #define GENPOLY (m_genpoly)
 #define NROOTS (m_nroots)
+#define FCR (m_fcr)
 #define A0 (NN)
 
 inline int MODNN(int x)
@@ -125,22 +118,34 @@ inline int MODNN(int x)
   return x;
 }
   
-CIL2PRS::CIL2PRS(uint8_t nroots) :
+CIL2PRS::CIL2PRS(uint8_t nroots, uint8_t fcr) :
 m_nroots(nroots),
-m_alphaTo(NULL),
-m_indexOf(NULL),
+m_fcr(fcr),
+m_alphaTo(RS_ALPHA_TO),
+m_indexOf(RS_INDEX_OF),
 m_genpoly(NULL)
 {
   switch (nroots) {
     case 2U:
-      m_alphaTo = ALPHA_TO_2;
-      m_indexOf = INDEX_OF_2;
       m_genpoly = GENPOLY_2;
       break;
+    case 4U:
+      m_genpoly = GENPOLY_4;
+      break;
+    case 6U:
+      m_genpoly = GENPOLY_6;
+      break;
+    case 8U:
+      m_genpoly = GENPOLY_8;
+      break;
     case 16U:
-      m_alphaTo = ALPHA_TO_16;
-      m_indexOf = INDEX_OF_16;
-      m_genpoly = GENPOLY_16;
+      m_genpoly = (fcr == 1U) ? FX25_GENPOLY_16 : GENPOLY_16;
+      break;
+    case 32U:
+      m_genpoly = FX25_GENPOLY_32;
+      break;
+    case 64U:
+      m_genpoly = FX25_GENPOLY_64;
       break;
   }
 }
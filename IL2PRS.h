@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2023 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -27,7 +27,7 @@
 
 class CIL2PRS {
 public:
-  CIL2PRS(uint8_t nroots);
+  CIL2PRS(uint8_t nroots, uint8_t fcr = 0U);   // IL2P uses a first root of 0, FX.25 uses 1
   ~CIL2PRS();
 
   void encode(uint8_t* data, uint8_t* parity) const;
@@ -35,6 +35,7 @@ public:
 
 private:
   uint8_t        m_nroots;       /* Number of generator roots = number of parity symbols */
+  uint8_t        m_fcr;          /* First consecutive root, index form */
   const uint8_t* m_alphaTo;      /* log lookup table */
   const uint8_t* m_indexOf;      /* Antilog lookup table */
   const uint8_t* m_genpoly;      /* Generator polynomial */
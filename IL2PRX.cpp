@@ -25,14 +25,64 @@ const uint16_t IL2P_HDR_LENGTH = 13U;
 
 const uint16_t RS_BLOCK_LENGTH = 255U;
 
-const uint16_t BIT_MASK_TABLE16[] = {0x0001U, 0x0002U, 0x0004U, 0x0008U, 0x0010U, 0x0020U, 0x0040U, 0x0080U, 0x0100U, 0x0200U, 0x0400U, 0x0800U, 0x1000U, 0x2000U, 0x4000U, 0x8000U};
-const uint8_t BIT_MASK_TABLE8[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT16(p,i,b) p = (b) ? (p | BIT_MASK_TABLE16[(i)]) : (p & ~BIT_MASK_TABLE16[(i)])
-#define READ_BIT16(p,i)    (p & BIT_MASK_TABLE16[(i)])
-
-#define WRITE_BIT8(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE8[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE8[(i)&7])
-#define READ_BIT8(p,i)    (p[(i)>>3] & BIT_MASK_TABLE8[(i)&7])
+// The unscrambler is linear, so the effect of eight bits on the shift register and
+// the output can be split into the part due to the low eight bits of the shift
+// register and the part due to the data byte. The low eight bits of the shift
+// register are all shifted out, so only bit 8 reaches the next state, where it
+// becomes bit 0, and it adds nothing to the output.
+const uint8_t UNSCRAMBLE_STATE_OUT[] = {
+  0x00U, 0x80U, 0x40U, 0xC0U, 0x20U, 0xA0U, 0x60U, 0xE0U, 0x10U, 0x90U, 0x50U, 0xD0U, 0x30U, 0xB0U, 0x70U, 0xF0U,
+  0x08U, 0x88U, 0x48U, 0xC8U, 0x28U, 0xA8U, 0x68U, 0xE8U, 0x18U, 0x98U, 0x58U, 0xD8U, 0x38U, 0xB8U, 0x78U, 0xF8U,
+  0x04U, 0x84U, 0x44U, 0xC4U, 0x24U, 0xA4U, 0x64U, 0xE4U, 0x14U, 0x94U, 0x54U, 0xD4U, 0x34U, 0xB4U, 0x74U, 0xF4U,
+  0x0CU, 0x8CU, 0x4CU, 0xCCU, 0x2CU, 0xACU, 0x6CU, 0xECU, 0x1CU, 0x9CU, 0x5CU, 0xDCU, 0x3CU, 0xBCU, 0x7CU, 0xFCU,
+  0x02U, 0x82U, 0x42U, 0xC2U, 0x22U, 0xA2U, 0x62U, 0xE2U, 0x12U, 0x92U, 0x52U, 0xD2U, 0x32U, 0xB2U, 0x72U, 0xF2U,
+  0x0AU, 0x8AU, 0x4AU, 0xCAU, 0x2AU, 0xAAU, 0x6AU, 0xEAU, 0x1AU, 0x9AU, 0x5AU, 0xDAU, 0x3AU, 0xBAU, 0x7AU, 0xFAU,
+  0x06U, 0x86U, 0x46U, 0xC6U, 0x26U, 0xA6U, 0x66U, 0xE6U, 0x16U, 0x96U, 0x56U, 0xD6U, 0x36U, 0xB6U, 0x76U, 0xF6U,
+  0x0EU, 0x8EU, 0x4EU, 0xCEU, 0x2EU, 0xAEU, 0x6EU, 0xEEU, 0x1EU, 0x9EU, 0x5EU, 0xDEU, 0x3EU, 0xBEU, 0x7EU, 0xFEU,
+  0x01U, 0x81U, 0x41U, 0xC1U, 0x21U, 0xA1U, 0x61U, 0xE1U, 0x11U, 0x91U, 0x51U, 0xD1U, 0x31U, 0xB1U, 0x71U, 0xF1U,
+  0x09U, 0x89U, 0x49U, 0xC9U, 0x29U, 0xA9U, 0x69U, 0xE9U, 0x19U, 0x99U, 0x59U, 0xD9U, 0x39U, 0xB9U, 0x79U, 0xF9U,
+  0x05U, 0x85U, 0x45U, 0xC5U, 0x25U, 0xA5U, 0x65U, 0xE5U, 0x15U, 0x95U, 0x55U, 0xD5U, 0x35U, 0xB5U, 0x75U, 0xF5U,
+  0x0DU, 0x8DU, 0x4DU, 0xCDU, 0x2DU, 0xADU, 0x6DU, 0xEDU, 0x1DU, 0x9DU, 0x5DU, 0xDDU, 0x3DU, 0xBDU, 0x7DU, 0xFDU,
+  0x03U, 0x83U, 0x43U, 0xC3U, 0x23U, 0xA3U, 0x63U, 0xE3U, 0x13U, 0x93U, 0x53U, 0xD3U, 0x33U, 0xB3U, 0x73U, 0xF3U,
+  0x0BU, 0x8BU, 0x4BU, 0xCBU, 0x2BU, 0xABU, 0x6BU, 0xEBU, 0x1BU, 0x9BU, 0x5BU, 0xDBU, 0x3BU, 0xBBU, 0x7BU, 0xFBU,
+  0x07U, 0x87U, 0x47U, 0xC7U, 0x27U, 0xA7U, 0x67U, 0xE7U, 0x17U, 0x97U, 0x57U, 0xD7U, 0x37U, 0xB7U, 0x77U, 0xF7U,
+  0x0FU, 0x8FU, 0x4FU, 0xCFU, 0x2FU, 0xAFU, 0x6FU, 0xEFU, 0x1FU, 0x9FU, 0x5FU, 0xDFU, 0x3FU, 0xBFU, 0x7FU, 0xFFU};
+
+const uint16_t UNSCRAMBLE_DATA_NEXT[] = {
+  0x0000U, 0x0108U, 0x0084U, 0x018CU, 0x0042U, 0x014AU, 0x00C6U, 0x01CEU, 0x0021U, 0x0129U, 0x00A5U, 0x01ADU, 0x0063U, 0x016BU, 0x00E7U, 0x01EFU,
+  0x0010U, 0x0118U, 0x0094U, 0x019CU, 0x0052U, 0x015AU, 0x00D6U, 0x01DEU, 0x0031U, 0x0139U, 0x00B5U, 0x01BDU, 0x0073U, 0x017BU, 0x00F7U, 0x01FFU,
+  0x0008U, 0x0100U, 0x008CU, 0x0184U, 0x004AU, 0x0142U, 0x00CEU, 0x01C6U, 0x0029U, 0x0121U, 0x00ADU, 0x01A5U, 0x006BU, 0x0163U, 0x00EFU, 0x01E7U,
+  0x0018U, 0x0110U, 0x009CU, 0x0194U, 0x005AU, 0x0152U, 0x00DEU, 0x01D6U, 0x0039U, 0x0131U, 0x00BDU, 0x01B5U, 0x007BU, 0x0173U, 0x00FFU, 0x01F7U,
+  0x0004U, 0x010CU, 0x0080U, 0x0188U, 0x0046U, 0x014EU, 0x00C2U, 0x01CAU, 0x0025U, 0x012DU, 0x00A1U, 0x01A9U, 0x0067U, 0x016FU, 0x00E3U, 0x01EBU,
+  0x0014U, 0x011CU, 0x0090U, 0x0198U, 0x0056U, 0x015EU, 0x00D2U, 0x01DAU, 0x0035U, 0x013DU, 0x00B1U, 0x01B9U, 0x0077U, 0x017FU, 0x00F3U, 0x01FBU,
+  0x000CU, 0x0104U, 0x0088U, 0x0180U, 0x004EU, 0x0146U, 0x00CAU, 0x01C2U, 0x002DU, 0x0125U, 0x00A9U, 0x01A1U, 0x006FU, 0x0167U, 0x00EBU, 0x01E3U,
+  0x001CU, 0x0114U, 0x0098U, 0x0190U, 0x005EU, 0x0156U, 0x00DAU, 0x01D2U, 0x003DU, 0x0135U, 0x00B9U, 0x01B1U, 0x007FU, 0x0177U, 0x00FBU, 0x01F3U,
+  0x0002U, 0x010AU, 0x0086U, 0x018EU, 0x0040U, 0x0148U, 0x00C4U, 0x01CCU, 0x0023U, 0x012BU, 0x00A7U, 0x01AFU, 0x0061U, 0x0169U, 0x00E5U, 0x01EDU,
+  0x0012U, 0x011AU, 0x0096U, 0x019EU, 0x0050U, 0x0158U, 0x00D4U, 0x01DCU, 0x0033U, 0x013BU, 0x00B7U, 0x01BFU, 0x0071U, 0x0179U, 0x00F5U, 0x01FDU,
+  0x000AU, 0x0102U, 0x008EU, 0x0186U, 0x0048U, 0x0140U, 0x00CCU, 0x01C4U, 0x002BU, 0x0123U, 0x00AFU, 0x01A7U, 0x0069U, 0x0161U, 0x00EDU, 0x01E5U,
+  0x001AU, 0x0112U, 0x009EU, 0x0196U, 0x0058U, 0x0150U, 0x00DCU, 0x01D4U, 0x003BU, 0x0133U, 0x00BFU, 0x01B7U, 0x0079U, 0x0171U, 0x00FDU, 0x01F5U,
+  0x0006U, 0x010EU, 0x0082U, 0x018AU, 0x0044U, 0x014CU, 0x00C0U, 0x01C8U, 0x0027U, 0x012FU, 0x00A3U, 0x01ABU, 0x0065U, 0x016DU, 0x00E1U, 0x01E9U,
+  0x0016U, 0x011EU, 0x0092U, 0x019AU, 0x0054U, 0x015CU, 0x00D0U, 0x01D8U, 0x0037U, 0x013FU, 0x00B3U, 0x01BBU, 0x0075U, 0x017DU, 0x00F1U, 0x01F9U,
+  0x000EU, 0x0106U, 0x008AU, 0x0182U, 0x004CU, 0x0144U, 0x00C8U, 0x01C0U, 0x002FU, 0x0127U, 0x00ABU, 0x01A3U, 0x006DU, 0x0165U, 0x00E9U, 0x01E1U,
+  0x001EU, 0x0116U, 0x009AU, 0x0192U, 0x005CU, 0x0154U, 0x00D8U, 0x01D0U, 0x003FU, 0x0137U, 0x00BBU, 0x01B3U, 0x007DU, 0x0175U, 0x00F9U, 0x01F1U};
+
+const uint8_t UNSCRAMBLE_DATA_OUT[] = {
+  0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U, 0x09U, 0x0AU, 0x0BU, 0x0CU, 0x0DU, 0x0EU, 0x0FU,
+  0x11U, 0x10U, 0x13U, 0x12U, 0x15U, 0x14U, 0x17U, 0x16U, 0x19U, 0x18U, 0x1BU, 0x1AU, 0x1DU, 0x1CU, 0x1FU, 0x1EU,
+  0x22U, 0x23U, 0x20U, 0x21U, 0x26U, 0x27U, 0x24U, 0x25U, 0x2AU, 0x2BU, 0x28U, 0x29U, 0x2EU, 0x2FU, 0x2CU, 0x2DU,
+  0x33U, 0x32U, 0x31U, 0x30U, 0x37U, 0x36U, 0x35U, 0x34U, 0x3BU, 0x3AU, 0x39U, 0x38U, 0x3FU, 0x3EU, 0x3DU, 0x3CU,
+  0x44U, 0x45U, 0x46U, 0x47U, 0x40U, 0x41U, 0x42U, 0x43U, 0x4CU, 0x4DU, 0x4EU, 0x4FU, 0x48U, 0x49U, 0x4AU, 0x4BU,
+  0x55U, 0x54U, 0x57U, 0x56U, 0x51U, 0x50U, 0x53U, 0x52U, 0x5DU, 0x5CU, 0x5FU, 0x5EU, 0x59U, 0x58U, 0x5BU, 0x5AU,
+  0x66U, 0x67U, 0x64U, 0x65U, 0x62U, 0x63U, 0x60U, 0x61U, 0x6EU, 0x6FU, 0x6CU, 0x6DU, 0x6AU, 0x6BU, 0x68U, 0x69U,
+  0x77U, 0x76U, 0x75U, 0x74U, 0x73U, 0x72U, 0x71U, 0x70U, 0x7FU, 0x7EU, 0x7DU, 0x7CU, 0x7BU, 0x7AU, 0x79U, 0x78U,
+  0x88U, 0x89U, 0x8AU, 0x8BU, 0x8CU, 0x8DU, 0x8EU, 0x8FU, 0x80U, 0x81U, 0x82U, 0x83U, 0x84U, 0x85U, 0x86U, 0x87U,
+  0x99U, 0x98U, 0x9BU, 0x9AU, 0x9DU, 0x9CU, 0x9FU, 0x9EU, 0x91U, 0x90U, 0x93U, 0x92U, 0x95U, 0x94U, 0x97U, 0x96U,
+  0xAAU, 0xABU, 0xA8U, 0xA9U, 0xAEU, 0xAFU, 0xACU, 0xADU, 0xA2U, 0xA3U, 0xA0U, 0xA1U, 0xA6U, 0xA7U, 0xA4U, 0xA5U,
+  0xBBU, 0xBAU, 0xB9U, 0xB8U, 0xBFU, 0xBEU, 0xBDU, 0xBCU, 0xB3U, 0xB2U, 0xB1U, 0xB0U, 0xB7U, 0xB6U, 0xB5U, 0xB4U,
+  0xCCU, 0xCDU, 0xCEU, 0xCFU, 0xC8U, 0xC9U, 0xCAU, 0xCBU, 0xC4U, 0xC5U, 0xC6U, 0xC7U, 0xC0U, 0xC1U, 0xC2U, 0xC3U,
+  0xDDU, 0xDCU, 0xDFU, 0xDEU, 0xD9U, 0xD8U, 0xDBU, 0xDAU, 0xD5U, 0xD4U, 0xD7U, 0xD6U, 0xD1U, 0xD0U, 0xD3U, 0xD2U,
+  0xEEU, 0xEFU, 0xECU, 0xEDU, 0xEAU, 0xEBU, 0xE8U, 0xE9U, 0xE6U, 0xE7U, 0xE4U, 0xE5U, 0xE2U, 0xE3U, 0xE0U, 0xE1U,
+  0xFFU, 0xFEU, 0xFDU, 0xFCU, 0xFBU, 0xFAU, 0xF9U, 0xF8U, 0xF7U, 0xF6U, 0xF5U, 0xF4U, 0xF3U, 0xF2U, 0xF1U, 0xF0U};
 
 static const struct IL2P_PID {
   uint8_t ax25PID;
@@ -57,6 +107,7 @@ m_rs8(8U),
 m_rs16(16U),
 m_crc(),
 m_hamming(),
+m_maxFEC(true),
 m_headerByteCount(0U),
 m_payloadByteCount(0U),
 m_payloadBlockCount(0U),
@@ -79,6 +130,8 @@ bool CIL2PRX::processHeader(const uint8_t* in, uint8_t* out)
 
   unscramble(buffer, IL2P_HDR_LENGTH);
 
+  m_maxFEC = (buffer[0U] & 0x80U) == 0x80U;
+
   bool type1 = (buffer[1U] & 0x80U) == 0x80U;
   if (type1)
     processType1Header(buffer, out);
@@ -147,7 +200,7 @@ void CIL2PRX::calculatePayloadBlockSize()
     m_largeBlockCount = 0U;
     m_smallBlockCount = 0U;
     m_paritySymbolsPerBlock = 0U;
-  } else {
+  } else if (m_maxFEC) {
     m_payloadBlockCount  =  m_payloadByteCount / 239U;
     m_payloadBlockCount += (m_payloadByteCount % 239U) > 0U ? 1U : 0U;
 
@@ -158,12 +211,31 @@ void CIL2PRX::calculatePayloadBlockSize()
     m_smallBlockCount = m_payloadBlockCount - m_largeBlockCount;
 
     m_paritySymbolsPerBlock = 16U;
+  } else {
+    m_payloadBlockCount  =  m_payloadByteCount / 247U;
+    m_payloadBlockCount += (m_payloadByteCount % 247U) > 0U ? 1U : 0U;
+
+    m_smallBlockSize = m_payloadByteCount / m_payloadBlockCount;
+    m_largeBlockSize = m_smallBlockSize + 1U;
+
+    m_largeBlockCount = m_payloadByteCount - (m_payloadBlockCount * m_smallBlockSize);
+    m_smallBlockCount = m_payloadBlockCount - m_largeBlockCount;
+
+    // Baseline FEC scales the parity with the block size
+    if (m_smallBlockSize <= 61U)
+      m_paritySymbolsPerBlock = 2U;
+    else if (m_smallBlockSize <= 123U)
+      m_paritySymbolsPerBlock = 4U;
+    else if (m_smallBlockSize <= 185U)
+      m_paritySymbolsPerBlock = 6U;
+    else
+      m_paritySymbolsPerBlock = 8U;
   }
 }
 
 void CIL2PRX::processType0Header(const uint8_t* in, uint8_t* out)
 {
-  DEBUG1("IL2PRX: type 0 header");
+  LOG_IL2P_TRACE("IL2PRX: type 0 header");
 
   m_headerByteCount  = 0U;
   m_payloadByteCount = 0U;
@@ -182,7 +254,7 @@ void CIL2PRX::processType0Header(const uint8_t* in, uint8_t* out)
 
 void CIL2PRX::processType1Header(const uint8_t* in, uint8_t* out)
 {
-  DEBUG1("IL2PRX: type 1 header");
+  LOG_IL2P_TRACE("IL2PRX: type 1 header");
 
   m_payloadByteCount = 0U;
 
@@ -341,21 +413,14 @@ bool CIL2PRX::checkCRC(const uint8_t* frame, const uint8_t* crc) const
 
 void CIL2PRX::unscramble(uint8_t* buffer, uint16_t length) const
 {
-  const uint16_t bitLength = length * 8U;
-
   uint16_t sr = 0x01F0U;
 
-  for (uint16_t i = 0U; i < bitLength; i++) {
-    bool b = READ_BIT8(buffer, i) != 0U;
+  for (uint16_t i = 0U; i < length; i++) {
+    uint8_t in = buffer[i];
 
-    if (b)
-      sr ^= 0x0211U;
+    buffer[i] = UNSCRAMBLE_STATE_OUT[sr & 0xFFU] ^ UNSCRAMBLE_DATA_OUT[in];
 
-    b = READ_BIT16(sr, 0U) != 0U;
-    
-    sr >>= 1;
-
-    WRITE_BIT8(buffer, i, b);
+    sr = UNSCRAMBLE_DATA_NEXT[in] ^ ((sr >> 8) & 0x0001U);
   }
 }
 
@@ -393,14 +458,24 @@ bool CIL2PRX::decode(uint8_t* buffer, uint16_t length, uint8_t numSymbols) const
 
   ::memcpy(buffer, rsBlock + RS_BLOCK_LENGTH - n, length);
 
+  if (derrors < 0) {
+    stats.increment(STATS_RS_FAILED);
+    return false;
+  }
+
   // It is possible to have a situation where too many errors are
   // present but the algorithm could get a good code block by "fixing"
   // one of the padding bytes that should be 0.
   for (int i = 0; i < derrors; i++) {
-    if (derrlocs[i] < (RS_BLOCK_LENGTH - n))
+    if (derrlocs[i] < (RS_BLOCK_LENGTH - n)) {
+      stats.increment(STATS_RS_FAILED);
       return false;
+    }
   }
 
+  if (derrors > 0)
+    stats.increment(STATS_RS_CORRECTED);
+
   return true;
 }
 
@@ -47,6 +47,7 @@ private:
   CIL2PRS  m_rs16;
   CAX25CRC m_crc;
   CHamming m_hamming;
+  bool     m_maxFEC;
   uint16_t m_headerByteCount;
   uint16_t m_payloadByteCount;
   uint16_t m_payloadBlockCount;
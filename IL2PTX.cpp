@@ -25,14 +25,81 @@ const uint16_t IL2P_HDR_LENGTH = 13U;
 
 const uint16_t RS_BLOCK_LENGTH = 255U;
 
-const uint16_t BIT_MASK_TABLE16[] = {0x0001U, 0x0002U, 0x0004U, 0x0008U, 0x0010U, 0x0020U, 0x0040U, 0x0080U, 0x0100U, 0x0200U, 0x0400U, 0x0800U, 0x1000U, 0x2000U, 0x4000U, 0x8000U};
-const uint8_t BIT_MASK_TABLE8[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT16(p,i,b) p = (b) ? (p | BIT_MASK_TABLE16[(i)]) : (p & ~BIT_MASK_TABLE16[(i)])
-#define READ_BIT16(p,i)    (p & BIT_MASK_TABLE16[(i)])
-
-#define WRITE_BIT8(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE8[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE8[(i)&7])
-#define READ_BIT8(p,i)    (p[(i)>>3] & BIT_MASK_TABLE8[(i)&7])
+// The scrambler is linear, so the effect of eight bits on the shift register and
+// the output can be split into the part due to the low eight bits of the shift
+// register and the part due to the data byte. Bit 8 of the shift register adds
+// 0x0001 to the next state and 0x08 to the output.
+const uint16_t SCRAMBLE_STATE_NEXT[] = {
+  0x0000U, 0x0023U, 0x0046U, 0x0065U, 0x008CU, 0x00AFU, 0x00CAU, 0x00E9U, 0x0118U, 0x013BU, 0x015EU, 0x017DU, 0x0194U, 0x01B7U, 0x01D2U, 0x01F1U,
+  0x0021U, 0x0002U, 0x0067U, 0x0044U, 0x00ADU, 0x008EU, 0x00EBU, 0x00C8U, 0x0139U, 0x011AU, 0x017FU, 0x015CU, 0x01B5U, 0x0196U, 0x01F3U, 0x01D0U,
+  0x0042U, 0x0061U, 0x0004U, 0x0027U, 0x00CEU, 0x00EDU, 0x0088U, 0x00ABU, 0x015AU, 0x0179U, 0x011CU, 0x013FU, 0x01D6U, 0x01F5U, 0x0190U, 0x01B3U,
+  0x0063U, 0x0040U, 0x0025U, 0x0006U, 0x00EFU, 0x00CCU, 0x00A9U, 0x008AU, 0x017BU, 0x0158U, 0x013DU, 0x011EU, 0x01F7U, 0x01D4U, 0x01B1U, 0x0192U,
+  0x0084U, 0x00A7U, 0x00C2U, 0x00E1U, 0x0008U, 0x002BU, 0x004EU, 0x006DU, 0x019CU, 0x01BFU, 0x01DAU, 0x01F9U, 0x0110U, 0x0133U, 0x0156U, 0x0175U,
+  0x00A5U, 0x0086U, 0x00E3U, 0x00C0U, 0x0029U, 0x000AU, 0x006FU, 0x004CU, 0x01BDU, 0x019EU, 0x01FBU, 0x01D8U, 0x0131U, 0x0112U, 0x0177U, 0x0154U,
+  0x00C6U, 0x00E5U, 0x0080U, 0x00A3U, 0x004AU, 0x0069U, 0x000CU, 0x002FU, 0x01DEU, 0x01FDU, 0x0198U, 0x01BBU, 0x0152U, 0x0171U, 0x0114U, 0x0137U,
+  0x00E7U, 0x00C4U, 0x00A1U, 0x0082U, 0x006BU, 0x0048U, 0x002DU, 0x000EU, 0x01FFU, 0x01DCU, 0x01B9U, 0x019AU, 0x0173U, 0x0150U, 0x0135U, 0x0116U,
+  0x0108U, 0x012BU, 0x014EU, 0x016DU, 0x0184U, 0x01A7U, 0x01C2U, 0x01E1U, 0x0010U, 0x0033U, 0x0056U, 0x0075U, 0x009CU, 0x00BFU, 0x00DAU, 0x00F9U,
+  0x0129U, 0x010AU, 0x016FU, 0x014CU, 0x01A5U, 0x0186U, 0x01E3U, 0x01C0U, 0x0031U, 0x0012U, 0x0077U, 0x0054U, 0x00BDU, 0x009EU, 0x00FBU, 0x00D8U,
+  0x014AU, 0x0169U, 0x010CU, 0x012FU, 0x01C6U, 0x01E5U, 0x0180U, 0x01A3U, 0x0052U, 0x0071U, 0x0014U, 0x0037U, 0x00DEU, 0x00FDU, 0x0098U, 0x00BBU,
+  0x016BU, 0x0148U, 0x012DU, 0x010EU, 0x01E7U, 0x01C4U, 0x01A1U, 0x0182U, 0x0073U, 0x0050U, 0x0035U, 0x0016U, 0x00FFU, 0x00DCU, 0x00B9U, 0x009AU,
+  0x018CU, 0x01AFU, 0x01CAU, 0x01E9U, 0x0100U, 0x0123U, 0x0146U, 0x0165U, 0x0094U, 0x00B7U, 0x00D2U, 0x00F1U, 0x0018U, 0x003BU, 0x005EU, 0x007DU,
+  0x01ADU, 0x018EU, 0x01EBU, 0x01C8U, 0x0121U, 0x0102U, 0x0167U, 0x0144U, 0x00B5U, 0x0096U, 0x00F3U, 0x00D0U, 0x0039U, 0x001AU, 0x007FU, 0x005CU,
+  0x01CEU, 0x01EDU, 0x0188U, 0x01ABU, 0x0142U, 0x0161U, 0x0104U, 0x0127U, 0x00D6U, 0x00F5U, 0x0090U, 0x00B3U, 0x005AU, 0x0079U, 0x001CU, 0x003FU,
+  0x01EFU, 0x01CCU, 0x01A9U, 0x018AU, 0x0163U, 0x0140U, 0x0125U, 0x0106U, 0x00F7U, 0x00D4U, 0x00B1U, 0x0092U, 0x007BU, 0x0058U, 0x003DU, 0x001EU};
+
+const uint8_t SCRAMBLE_STATE_OUT[] = {
+  0x00U, 0x8CU, 0x46U, 0xCAU, 0x23U, 0xAFU, 0x65U, 0xE9U, 0x11U, 0x9DU, 0x57U, 0xDBU, 0x32U, 0xBEU, 0x74U, 0xF8U,
+  0x88U, 0x04U, 0xCEU, 0x42U, 0xABU, 0x27U, 0xEDU, 0x61U, 0x99U, 0x15U, 0xDFU, 0x53U, 0xBAU, 0x36U, 0xFCU, 0x70U,
+  0x44U, 0xC8U, 0x02U, 0x8EU, 0x67U, 0xEBU, 0x21U, 0xADU, 0x55U, 0xD9U, 0x13U, 0x9FU, 0x76U, 0xFAU, 0x30U, 0xBCU,
+  0xCCU, 0x40U, 0x8AU, 0x06U, 0xEFU, 0x63U, 0xA9U, 0x25U, 0xDDU, 0x51U, 0x9BU, 0x17U, 0xFEU, 0x72U, 0xB8U, 0x34U,
+  0x22U, 0xAEU, 0x64U, 0xE8U, 0x01U, 0x8DU, 0x47U, 0xCBU, 0x33U, 0xBFU, 0x75U, 0xF9U, 0x10U, 0x9CU, 0x56U, 0xDAU,
+  0xAAU, 0x26U, 0xECU, 0x60U, 0x89U, 0x05U, 0xCFU, 0x43U, 0xBBU, 0x37U, 0xFDU, 0x71U, 0x98U, 0x14U, 0xDEU, 0x52U,
+  0x66U, 0xEAU, 0x20U, 0xACU, 0x45U, 0xC9U, 0x03U, 0x8FU, 0x77U, 0xFBU, 0x31U, 0xBDU, 0x54U, 0xD8U, 0x12U, 0x9EU,
+  0xEEU, 0x62U, 0xA8U, 0x24U, 0xCDU, 0x41U, 0x8BU, 0x07U, 0xFFU, 0x73U, 0xB9U, 0x35U, 0xDCU, 0x50U, 0x9AU, 0x16U,
+  0x11U, 0x9DU, 0x57U, 0xDBU, 0x32U, 0xBEU, 0x74U, 0xF8U, 0x00U, 0x8CU, 0x46U, 0xCAU, 0x23U, 0xAFU, 0x65U, 0xE9U,
+  0x99U, 0x15U, 0xDFU, 0x53U, 0xBAU, 0x36U, 0xFCU, 0x70U, 0x88U, 0x04U, 0xCEU, 0x42U, 0xABU, 0x27U, 0xEDU, 0x61U,
+  0x55U, 0xD9U, 0x13U, 0x9FU, 0x76U, 0xFAU, 0x30U, 0xBCU, 0x44U, 0xC8U, 0x02U, 0x8EU, 0x67U, 0xEBU, 0x21U, 0xADU,
+  0xDDU, 0x51U, 0x9BU, 0x17U, 0xFEU, 0x72U, 0xB8U, 0x34U, 0xCCU, 0x40U, 0x8AU, 0x06U, 0xEFU, 0x63U, 0xA9U, 0x25U,
+  0x33U, 0xBFU, 0x75U, 0xF9U, 0x10U, 0x9CU, 0x56U, 0xDAU, 0x22U, 0xAEU, 0x64U, 0xE8U, 0x01U, 0x8DU, 0x47U, 0xCBU,
+  0xBBU, 0x37U, 0xFDU, 0x71U, 0x98U, 0x14U, 0xDEU, 0x52U, 0xAAU, 0x26U, 0xECU, 0x60U, 0x89U, 0x05U, 0xCFU, 0x43U,
+  0x77U, 0xFBU, 0x31U, 0xBDU, 0x54U, 0xD8U, 0x12U, 0x9EU, 0x66U, 0xEAU, 0x20U, 0xACU, 0x45U, 0xC9U, 0x03U, 0x8FU,
+  0xFFU, 0x73U, 0xB9U, 0x35U, 0xDCU, 0x50U, 0x9AU, 0x16U, 0xEEU, 0x62U, 0xA8U, 0x24U, 0xCDU, 0x41U, 0x8BU, 0x07U};
+
+const uint16_t SCRAMBLE_DATA_NEXT[] = {
+  0x0000U, 0x0100U, 0x0080U, 0x0180U, 0x0040U, 0x0140U, 0x00C0U, 0x01C0U, 0x0020U, 0x0120U, 0x00A0U, 0x01A0U, 0x0060U, 0x0160U, 0x00E0U, 0x01E0U,
+  0x0010U, 0x0110U, 0x0090U, 0x0190U, 0x0050U, 0x0150U, 0x00D0U, 0x01D0U, 0x0030U, 0x0130U, 0x00B0U, 0x01B0U, 0x0070U, 0x0170U, 0x00F0U, 0x01F0U,
+  0x0008U, 0x0108U, 0x0088U, 0x0188U, 0x0048U, 0x0148U, 0x00C8U, 0x01C8U, 0x0028U, 0x0128U, 0x00A8U, 0x01A8U, 0x0068U, 0x0168U, 0x00E8U, 0x01E8U,
+  0x0018U, 0x0118U, 0x0098U, 0x0198U, 0x0058U, 0x0158U, 0x00D8U, 0x01D8U, 0x0038U, 0x0138U, 0x00B8U, 0x01B8U, 0x0078U, 0x0178U, 0x00F8U, 0x01F8U,
+  0x0004U, 0x0104U, 0x0084U, 0x0184U, 0x0044U, 0x0144U, 0x00C4U, 0x01C4U, 0x0024U, 0x0124U, 0x00A4U, 0x01A4U, 0x0064U, 0x0164U, 0x00E4U, 0x01E4U,
+  0x0014U, 0x0114U, 0x0094U, 0x0194U, 0x0054U, 0x0154U, 0x00D4U, 0x01D4U, 0x0034U, 0x0134U, 0x00B4U, 0x01B4U, 0x0074U, 0x0174U, 0x00F4U, 0x01F4U,
+  0x000CU, 0x010CU, 0x008CU, 0x018CU, 0x004CU, 0x014CU, 0x00CCU, 0x01CCU, 0x002CU, 0x012CU, 0x00ACU, 0x01ACU, 0x006CU, 0x016CU, 0x00ECU, 0x01ECU,
+  0x001CU, 0x011CU, 0x009CU, 0x019CU, 0x005CU, 0x015CU, 0x00DCU, 0x01DCU, 0x003CU, 0x013CU, 0x00BCU, 0x01BCU, 0x007CU, 0x017CU, 0x00FCU, 0x01FCU,
+  0x0002U, 0x0102U, 0x0082U, 0x0182U, 0x0042U, 0x0142U, 0x00C2U, 0x01C2U, 0x0022U, 0x0122U, 0x00A2U, 0x01A2U, 0x0062U, 0x0162U, 0x00E2U, 0x01E2U,
+  0x0012U, 0x0112U, 0x0092U, 0x0192U, 0x0052U, 0x0152U, 0x00D2U, 0x01D2U, 0x0032U, 0x0132U, 0x00B2U, 0x01B2U, 0x0072U, 0x0172U, 0x00F2U, 0x01F2U,
+  0x000AU, 0x010AU, 0x008AU, 0x018AU, 0x004AU, 0x014AU, 0x00CAU, 0x01CAU, 0x002AU, 0x012AU, 0x00AAU, 0x01AAU, 0x006AU, 0x016AU, 0x00EAU, 0x01EAU,
+  0x001AU, 0x011AU, 0x009AU, 0x019AU, 0x005AU, 0x015AU, 0x00DAU, 0x01DAU, 0x003AU, 0x013AU, 0x00BAU, 0x01BAU, 0x007AU, 0x017AU, 0x00FAU, 0x01FAU,
+  0x0006U, 0x0106U, 0x0086U, 0x0186U, 0x0046U, 0x0146U, 0x00C6U, 0x01C6U, 0x0026U, 0x0126U, 0x00A6U, 0x01A6U, 0x0066U, 0x0166U, 0x00E6U, 0x01E6U,
+  0x0016U, 0x0116U, 0x0096U, 0x0196U, 0x0056U, 0x0156U, 0x00D6U, 0x01D6U, 0x0036U, 0x0136U, 0x00B6U, 0x01B6U, 0x0076U, 0x0176U, 0x00F6U, 0x01F6U,
+  0x000EU, 0x010EU, 0x008EU, 0x018EU, 0x004EU, 0x014EU, 0x00CEU, 0x01CEU, 0x002EU, 0x012EU, 0x00AEU, 0x01AEU, 0x006EU, 0x016EU, 0x00EEU, 0x01EEU,
+  0x001EU, 0x011EU, 0x009EU, 0x019EU, 0x005EU, 0x015EU, 0x00DEU, 0x01DEU, 0x003EU, 0x013EU, 0x00BEU, 0x01BEU, 0x007EU, 0x017EU, 0x00FEU, 0x01FEU};
+
+const uint8_t SCRAMBLE_DATA_OUT[] = {
+  0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+  0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+  0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U,
+  0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U, 0x01U,
+  0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U,
+  0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U, 0x02U,
+  0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U,
+  0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U, 0x03U,
+  0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U,
+  0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U, 0x04U,
+  0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U,
+  0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U, 0x05U,
+  0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U,
+  0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U, 0x06U,
+  0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U,
+  0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U, 0x07U};
 
 static const struct IL2P_PID {
   uint8_t ax25PID;
@@ -57,6 +124,7 @@ m_rs8(8U),
 m_rs16(16U),
 m_crc(),
 m_hamming(),
+m_maxFEC(true),
 m_payloadByteCount(0U),
 m_payloadOffset(0U),
 m_payloadBlockCount(0U),
@@ -68,47 +136,50 @@ m_paritySymbolsPerBlock(0U)
 {
 }
 
-uint16_t CIL2PTX::process(const uint8_t* in, uint16_t inLength, uint8_t* out)
+uint16_t CIL2PTX::process(const uint8_t* in, uint16_t inLength, CRingBuffer<uint8_t>& out)
 {
   uint16_t crc = m_crc.calculate(in, inLength);
 
+  uint8_t header[IL2P_HDR_LENGTH];
+
   bool type1 = isIL2PType1(in, inLength);
   if (type1)
-    processType1Header(in, inLength, out);
+    processType1Header(in, inLength, header);
   else
-    processType0Header(in, inLength, out);
+    processType0Header(in, inLength, header);
 
   calculatePayloadBlockSize();
 
-  // Scramble and RS encode the IL2P header
-  scramble(out, IL2P_HDR_LENGTH);
-  uint8_t len = encode(out, IL2P_HDR_LENGTH, 2U);
-  uint16_t outLength = len;
+  // Each block is scrambled and RS encoded as it is written to the output
+  uint16_t outLength = encode(header, IL2P_HDR_LENGTH, 2U, out);
 
   for (uint8_t i = 0U; i < m_largeBlockCount; i++) {
-    ::memcpy(out + outLength, in + m_payloadOffset, m_largeBlockSize);
-    scramble(out + outLength, m_largeBlockSize);
-    len = encode(out + outLength, m_largeBlockSize, m_paritySymbolsPerBlock);
-
+    outLength       += encode(in + m_payloadOffset, m_largeBlockSize, m_paritySymbolsPerBlock, out);
     m_payloadOffset += m_largeBlockSize;
-    outLength       += len;
   }
 
   for (uint8_t i = 0U; i < m_smallBlockCount; i++) {
-    ::memcpy(out + outLength, in + m_payloadOffset, m_smallBlockSize);
-    scramble(out + outLength, m_smallBlockSize);
-    len = encode(out + outLength, m_smallBlockSize, m_paritySymbolsPerBlock);
-
+    outLength       += encode(in + m_payloadOffset, m_smallBlockSize, m_paritySymbolsPerBlock, out);
     m_payloadOffset += m_smallBlockSize;
-    outLength       += len;
   }
 
-  out[outLength++] = m_hamming.encode(crc >> 12);
-  out[outLength++] = m_hamming.encode(crc >> 8);
-  out[outLength++] = m_hamming.encode(crc >> 4);
-  out[outLength++] = m_hamming.encode(crc >> 0);
+  uint8_t trailer[4U];
+  trailer[0U] = m_hamming.encode(crc >> 12);
+  trailer[1U] = m_hamming.encode(crc >> 8);
+  trailer[2U] = m_hamming.encode(crc >> 4);
+  trailer[3U] = m_hamming.encode(crc >> 0);
+
+  out.put(trailer, 4U);
+
+  return outLength + 4U;
+}
+
+uint16_t CIL2PTX::getMaxLength(uint16_t inLength) const
+{
+  // The worst case is a type 0 header and Max FEC over the whole frame
+  uint16_t blocks = (inLength + 238U) / 239U;
 
-  return outLength;
+  return IL2P_HDR_LENGTH + 2U + inLength + blocks * 16U + 4U;
 }
 
 bool CIL2PTX::isIL2PType1(const uint8_t* frame, uint16_t length) const
@@ -165,11 +236,12 @@ bool CIL2PTX::isIL2PType1(const uint8_t* frame, uint16_t length) const
 
 void CIL2PTX::processType0Header(const uint8_t* in, uint16_t length, uint8_t* out)
 {
-  DEBUG1("IL2PTX: type 0 header");
+  LOG_IL2P_TRACE("IL2PTX: type 0 header");
 
   ::memset(out, 0x00U, IL2P_HDR_LENGTH);
 
-  out[0U] |= 0x80U;      // Using Max FEC
+  if (m_maxFEC)
+    out[0U] |= 0x80U;    // Using Max FEC
 
   out[2U]  = (length & 0x0200U) == 0x0200U ? 0x80U : 0x00U;
   out[3U]  = (length & 0x0100U) == 0x0100U ? 0x80U : 0x00U;
@@ -188,7 +260,7 @@ void CIL2PTX::processType0Header(const uint8_t* in, uint16_t length, uint8_t* ou
 
 void CIL2PTX::processType1Header(const uint8_t* in, uint16_t length, uint8_t* out)
 {
-  DEBUG1("IL2PTX: type 1 header");
+  LOG_IL2P_TRACE("IL2PTX: type 1 header");
 
   ::memset(out, 0x00U, IL2P_HDR_LENGTH);
 
@@ -201,7 +273,8 @@ void CIL2PTX::processType1Header(const uint8_t* in, uint16_t length, uint8_t* ou
     out[i + 6U] = (in[i + 7U] >> 1) - 0x20U;  // Source callsign
   }
  
-  out[0U] |= 0x80U;      // Using Max FEC
+  if (m_maxFEC)
+    out[0U] |= 0x80U;    // Using Max FEC
   out[1U] |= 0x80U;      // It's a type 1 header
 
   out[12U]  = (in[13U] >> 1) & 0x0FU;  // The source SSID
@@ -338,7 +411,7 @@ void CIL2PTX::calculatePayloadBlockSize()
     m_largeBlockCount = 0U;
     m_smallBlockCount = 0U;
     m_paritySymbolsPerBlock = 0U;
-  } else {
+  } else if (m_maxFEC) {
     m_payloadBlockCount  =  m_payloadByteCount / 239U;
     m_payloadBlockCount += (m_payloadByteCount % 239U) > 0U ? 1U : 0U;
 
@@ -349,53 +422,69 @@ void CIL2PTX::calculatePayloadBlockSize()
     m_smallBlockCount = m_payloadBlockCount - m_largeBlockCount;
 
     m_paritySymbolsPerBlock = 16U;
+  } else {
+    m_payloadBlockCount  =  m_payloadByteCount / 247U;
+    m_payloadBlockCount += (m_payloadByteCount % 247U) > 0U ? 1U : 0U;
+
+    m_smallBlockSize = m_payloadByteCount / m_payloadBlockCount;
+    m_largeBlockSize = m_smallBlockSize + 1U;
+
+    m_largeBlockCount = m_payloadByteCount - (m_payloadBlockCount * m_smallBlockSize);
+    m_smallBlockCount = m_payloadBlockCount - m_largeBlockCount;
+
+    // Baseline FEC scales the parity with the block size
+    if (m_smallBlockSize <= 61U)
+      m_paritySymbolsPerBlock = 2U;
+    else if (m_smallBlockSize <= 123U)
+      m_paritySymbolsPerBlock = 4U;
+    else if (m_smallBlockSize <= 185U)
+      m_paritySymbolsPerBlock = 6U;
+    else
+      m_paritySymbolsPerBlock = 8U;
   }
 }
 
+void CIL2PTX::setMaxFEC(bool on)
+{
+  m_maxFEC = on;
+}
+
 void CIL2PTX::scramble(uint8_t* buffer, uint16_t length) const
 {
-  const uint16_t bitLength = length * 8U;
+  if (length == 0U)
+    return;
 
   uint16_t sr = 0x000FU;
 
-  uint16_t pos = 0U;
-  for (uint16_t i = 0U; i < bitLength; i++) {
-    bool b  = READ_BIT8(buffer, i) != 0U;
-    bool fb = READ_BIT16(sr, 0U) != 0U;
-
-    sr >>= 1;
-
-    WRITE_BIT16(sr, 8U, b);
-
-    if (fb)
-      sr ^= 0x0108U;
-
-    b = READ_BIT16(sr, 3U) != 0U;
-
-    if (i > 4U) {
-      WRITE_BIT8(buffer, pos, b);
-      pos++;
+  // The output is five bits behind the input, so each output byte is made
+  // from the end of one scrambled byte and the start of the next one
+  uint8_t last = 0U;
+  for (uint16_t i = 0U; i <= length; i++) {
+    uint8_t in = (i < length) ? buffer[i] : 0x00U;      // Zeros flush the shift register
+
+    uint8_t out = SCRAMBLE_STATE_OUT[sr & 0xFFU] ^ SCRAMBLE_DATA_OUT[in];
+    uint16_t next = SCRAMBLE_STATE_NEXT[sr & 0xFFU] ^ SCRAMBLE_DATA_NEXT[in];
+    if ((sr & 0x0100U) == 0x0100U) {
+      out  ^= 0x08U;
+      next ^= 0x0001U;
     }
-  }
+    sr = next;
 
-  for (uint8_t i = 0U; i < 5U; i++, pos++) {
-    bool fb = READ_BIT16(sr, 0U) != 0U;
+    if (i > 0U)
+      buffer[i - 1U] = (last << 5) | (out >> 3);
 
-    sr >>= 1;
-
-    if (fb)
-      sr ^= 0x0108U;
-
-    bool b = READ_BIT16(sr, 3U) != 0U;
-    WRITE_BIT8(buffer, pos, b);
+    last = out;
   }
 }
 
-uint8_t CIL2PTX::encode(uint8_t* buffer, uint16_t length, uint8_t numSymbols) const
+uint16_t CIL2PTX::encode(const uint8_t* in, uint16_t length, uint8_t numSymbols, CRingBuffer<uint8_t>& out) const
 {
   uint8_t rsBlock[RS_BLOCK_LENGTH];
-  ::memset(rsBlock, 0x00U, RS_BLOCK_LENGTH);
-  ::memcpy(rsBlock + RS_BLOCK_LENGTH - length - numSymbols, buffer, length);
+  ::memset(rsBlock, 0x00U, RS_BLOCK_LENGTH - length - numSymbols);
+
+  uint8_t* data = rsBlock + RS_BLOCK_LENGTH - length - numSymbols;
+  ::memcpy(data, in, length);
+  scramble(data, length);
 
   uint8_t parity[16U];
 
@@ -417,7 +506,8 @@ uint8_t CIL2PTX::encode(uint8_t* buffer, uint16_t length, uint8_t numSymbols) co
       break;
   }
 
-  ::memcpy(buffer + length, parity, numSymbols);
+  out.put(data, length);
+  out.put(parity, numSymbols);
 
   return length + numSymbols;
 }
@@ -22,6 +22,7 @@
 #include "IL2PRS.h"
 #include "AX25CRC.h"
 #include "Hamming.h"
+#include "RingBuffer.h"
 
 #include <cstdint>
 
@@ -29,7 +30,11 @@ class CIL2PTX {
 public:
   CIL2PTX();
 
-  uint16_t process(const uint8_t* in, uint16_t inLength, uint8_t* out);
+  uint16_t process(const uint8_t* in, uint16_t inLength, CRingBuffer<uint8_t>& out);
+
+  uint16_t getMaxLength(uint16_t inLength) const;
+
+  void setMaxFEC(bool on);
 
 private:
   CIL2PRS  m_rs2;
@@ -39,6 +44,7 @@ private:
   CIL2PRS  m_rs16;
   CAX25CRC m_crc;
   CHamming m_hamming;
+  bool     m_maxFEC;
   uint16_t m_payloadByteCount;
   uint16_t m_payloadOffset;
   uint8_t  m_payloadBlockCount;
@@ -56,7 +62,7 @@ private:
 
   void scramble(uint8_t* buffer, uint16_t length) const;
 
-  uint8_t encode(uint8_t* buffer, uint16_t length, uint8_t numSymbols) const;
+  uint16_t encode(const uint8_t* in, uint16_t length, uint8_t numSymbols, CRingBuffer<uint8_t>& out) const;
 };
 
 #endif
@@ -32,6 +32,10 @@ m_pPersist(P_PERSISTENCE),
 m_slotTime((SLOT_TIME / 10U) * 240U),
 m_dcd(false),
 m_ledCount(0U),
+m_sampleCount(0U),
+m_rxSampleIndex(0U),
+m_txWritten(0U),
+m_txSent(0U),
 m_ledValue(true),
 m_slotCount(0U),
 m_canTX(false),
@@ -119,10 +123,19 @@ void CIO::process()
   if (m_txBuffer.getData() == 0U && m_tx) {
     m_tx = false;
     setPTTInt(false);
-    DEBUG1("TX OFF");
+    LOG_GENERAL_INFO("TX OFF");
   }
 
+  if (m_rxBuffer.hasOverflowed())
+    stats.increment(STATS_RX_OVERFLOWS);
+
+  if (m_txBuffer.hasOverflowed())
+    stats.increment(STATS_TX_OVERFLOWS);
+
   if (m_rxBuffer.getData() >= RX_BLOCK_SIZE) {
+    if (m_dcd)
+      stats.addBusySamples(RX_BLOCK_SIZE);
+
     // Only do the CSMA calculations when in simplex mode
     if (!m_duplex) {
       if (m_dcd) {
@@ -136,6 +149,9 @@ void CIO::process()
       }
     }
 
+    // The index of the last sample of the block, it may be a sample out as the interrupt is not held off
+    m_rxSampleIndex = m_sampleCount - m_rxBuffer.getData() + RX_BLOCK_SIZE - 1U;
+
     q15_t samples[RX_BLOCK_SIZE];
 
     for (uint16_t i = 0U; i < RX_BLOCK_SIZE; i++) {
@@ -149,13 +165,19 @@ void CIO::process()
 
     switch (m_mode) {
       case 1U:
+      case 5U:
         ax25RX.samples(samples, RX_BLOCK_SIZE);
         break;
 
       case 2U:
+      case 4U:
         mode2RX.samples(samples, RX_BLOCK_SIZE);
         break;
 
+      case 3U:
+        mode3RX.samples(samples, RX_BLOCK_SIZE);
+        break;
+
       default:
         break;
     }
@@ -168,12 +190,23 @@ void CIO::write(q15_t* samples, uint16_t length)
   if (!m_tx) {
     m_tx = true;
     setPTTInt(true);
-    DEBUG1("TX ON");
+    stats.increment(STATS_PTT_KEYUPS);
+    LOG_GENERAL_INFO("TX ON");
   }
 
-  for (uint16_t i = 0U; i < length; i++) {
-    uint16_t res = uint16_t(samples[i] + DC_OFFSET);
-    m_txBuffer.put(res);
+  // Offset the samples a block at a time and copy each block into the ring in one go
+  while (length > 0U) {
+    uint16_t buffer[50U];
+    uint16_t n = (length < 50U) ? length : 50U;
+
+    for (uint16_t i = 0U; i < n; i++)
+      buffer[i] = uint16_t(samples[i] + DC_OFFSET);
+
+    if (m_txBuffer.put(buffer, n))
+      m_txWritten += n;
+
+    samples += n;
+    length  -= n;
   }
 }
 
@@ -182,6 +215,7 @@ void CIO::showMode()
 #if defined(MODE_LEDS)
   switch (m_mode) {
     case 1U:
+    case 5U:
       setMode1Int(true);
       setMode2Int(false);
       setMode3Int(false);
@@ -193,6 +227,18 @@ void CIO::showMode()
       setMode3Int(false);
       setMode4Int(false);
       break;
+    case 3U:
+      setMode1Int(false);
+      setMode2Int(false);
+      setMode3Int(true);
+      setMode4Int(false);
+      break;
+    case 4U:
+      setMode1Int(false);
+      setMode2Int(false);
+      setMode3Int(false);
+      setMode4Int(true);
+      break;
     default:
       setMode1Int(false);
       setMode2Int(false);
@@ -242,6 +288,26 @@ bool CIO::canTX() const
   return m_canTX;
 }
 
+uint32_t CIO::getSampleCount() const
+{
+  return m_sampleCount;
+}
+
+uint32_t CIO::getRXSampleIndex() const
+{
+  return m_rxSampleIndex;
+}
+
+uint32_t CIO::getTXWritten() const
+{
+  return m_txWritten;
+}
+
+uint32_t CIO::getTXSent() const
+{
+  return m_txSent;
+}
+
 // Taken from https://www.electro-tech-online.com/threads/ultra-fast-pseudorandom-number-generator-for-8-bit.124249/
 //X ABC Algorithm Random Number Generator for 8-Bit Devices:
 //This is a small PRNG, experimentally verified to have at least a 50 million byte period
@@ -280,4 +346,3 @@ uint8_t CIO::rand()
 
   return uint8_t(m_c);             //low order bits of other variables
 }
-
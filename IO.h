@@ -54,6 +54,12 @@ public:
 
   bool canTX() const;
 
+  uint32_t getSampleCount() const;
+  uint32_t getRXSampleIndex() const;
+
+  uint32_t getTXWritten() const;
+  uint32_t getTXSent() const;
+
 private:
   CRingBuffer<uint16_t>  m_rxBuffer;
   CRingBuffer<uint16_t>  m_txBuffer;
@@ -65,6 +71,10 @@ private:
   bool                   m_dcd;
 
   volatile uint32_t      m_ledCount;
+  volatile uint32_t      m_sampleCount;
+  uint32_t               m_rxSampleIndex;
+  uint32_t               m_txWritten;
+  volatile uint32_t      m_txSent;
   bool                   m_ledValue;
 
   uint32_t               m_slotCount;
@@ -221,7 +221,8 @@ void CIO::interrupt()
 {
   uint16_t sample = DC_OFFSET;
 
-  m_txBuffer.get(sample);
+  if (m_txBuffer.get(sample))
+    m_txSent++;
 
   // Send the value to the DAC
 #if defined(STM32F4_NUCLEO) && defined(STM32F4_NUCLEO_ARDUINO_HEADER)
@@ -245,6 +246,7 @@ void CIO::interrupt()
   m_rxBuffer.put(sample);
 
   m_ledCount++;
+  m_sampleCount++;
 }
 
 void CIO::setLEDInt(bool on)
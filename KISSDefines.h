@@ -33,8 +33,14 @@ const uint8_t KISS_TYPE_SLOT_TIME      = 0x03U;
 const uint8_t KISS_TYPE_TX_TAIL        = 0x04U;
 const uint8_t KISS_TYPE_FULL_DUPLEX    = 0x05U;
 const uint8_t KISS_TYPE_SET_HARDWARE   = 0x06U;
+const uint8_t KISS_TYPE_SET_SPEED      = 0x07U;
+const uint8_t KISS_TYPE_STATISTICS     = 0x08U;
+const uint8_t KISS_TYPE_LOG_LEVELS     = 0x09U;
+const uint8_t KISS_TYPE_TIMESTAMPS     = 0x0AU;
+const uint8_t KISS_TYPE_ACK_TIMES      = 0x0BU;
 const uint8_t KISS_TYPE_DATA_WITH_ACK  = 0x0CU;
 const uint8_t KISS_TYPE_ACK            = 0x0CU;
+const uint8_t KISS_TYPE_FREQ_OFFSET    = 0x0DU;
 const uint8_t KISS_TYPE_POLL           = 0x0EU;
 
 #endif
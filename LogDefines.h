@@ -0,0 +1,38 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(LOGDEFINES_H)
+#define  LOGDEFINES_H
+
+// The log levels, a message is sent if its level is no higher than the level of its subsystem
+#define  LOGL_NONE   0
+#define  LOGL_ERROR  1
+#define  LOGL_INFO   2
+#define  LOGL_TRACE  3
+
+// The order is that of the levels in the KISS log levels frame, new subsystems are only added at the end
+enum LOG_SUBSYSTEM {
+  LOGS_GENERAL,
+  LOGS_MODE1,
+  LOGS_IL2P,
+  LOGS_MODE2,
+  LOGS_MODE3,
+  LOGS_COUNT
+};
+
+#endif
@@ -32,9 +32,14 @@ CAX25TX ax25TX;
 CMode2TX mode2TX;
 CMode2RX mode2RX;
 
+CMode3TX mode3TX;
+CMode3RX mode3RX;
+
 CSerialPort serial;
 CIO io;
 
+CStatistics stats;
+
 void setup()
 {
   io.start();
@@ -51,11 +56,16 @@ void loop()
   // The following is for transmitting
   switch (m_mode) {
     case 1U:
+    case 5U:
       ax25TX.process();
       break;
     case 2U:
+    case 4U:
       mode2TX.process();
       break;
+    case 3U:
+      mode3TX.process();
+      break;
   }
 }
 
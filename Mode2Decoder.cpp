@@ -0,0 +1,296 @@
+/*
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "KISSDefines.h"
+#include "Globals.h"
+#include "Mode2Decoder.h"
+
+const uint16_t NOENDPTR = 9999U;
+
+const uint8_t LEVEL_TRACK_SHIFT = 5U;    // Level tracking time constant of 32 symbols
+
+CMode2Decoder::CMode2Decoder() :
+m_state(MODE2RXS_NONE),
+m_startPtr(NOENDPTR),
+m_endPtr(NOENDPTR),
+m_syncPtr(NOENDPTR),
+m_syncPhase(0U),
+m_invert(false),
+m_corr(0),
+m_start(0U),
+m_frame(),
+m_levels(),
+m_centreVal(0),
+m_thresholdVal(0),
+m_packet()
+{
+}
+
+void CMode2Decoder::start(uint16_t syncPtr, uint8_t syncPhase, q15_t centre, q15_t threshold, bool invert, q31_t corr, uint32_t start)
+{
+  m_state        = MODE2RXS_HEADER;
+  m_syncPtr      = syncPtr;
+  m_syncPhase    = syncPhase;
+  m_centreVal    = centre;
+  m_thresholdVal = threshold;
+  m_invert       = invert;
+  m_corr         = corr;
+  m_start        = start;
+
+  // The header starts right after the sync vector
+  m_startPtr = syncPtr + MODE2_RADIO_SYMBOL_LENGTH;
+  if (m_startPtr >= MODE2_MAX_LENGTH_SAMPLES)
+    m_startPtr -= MODE2_MAX_LENGTH_SAMPLES;
+
+  m_endPtr = m_startPtr + MODE2_HEADER_LENGTH_SAMPLES + MODE2_HEADER_PARITY_SAMPLES;
+  if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
+    m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
+
+  initLevels();
+}
+
+void CMode2Decoder::reset()
+{
+  m_state        = MODE2RXS_NONE;
+  m_startPtr     = NOENDPTR;
+  m_endPtr       = NOENDPTR;
+  m_syncPtr      = NOENDPTR;
+  m_corr         = 0;
+  m_centreVal    = 0;
+  m_thresholdVal = 0;
+
+  // The polarity and the levels are kept, the frequency offset of the last frame is found from them
+}
+
+bool CMode2Decoder::isBusy() const
+{
+  return m_state != MODE2RXS_NONE;
+}
+
+uint16_t CMode2Decoder::getSyncPtr() const
+{
+  return m_syncPtr;
+}
+
+q31_t CMode2Decoder::getCorrelation() const
+{
+  return m_corr;
+}
+
+bool CMode2Decoder::getInvert() const
+{
+  return m_invert;
+}
+
+q15_t CMode2Decoder::getCentre() const
+{
+  return (m_levels[0U] + m_levels[1U] + m_levels[2U] + m_levels[3U]) / 4;
+}
+
+q15_t CMode2Decoder::getOuterLevel() const
+{
+  return (m_levels[3U] - m_levels[0U]) / 2;
+}
+
+bool CMode2Decoder::process(const q15_t* buffer, uint16_t dataPtr, uint8_t bitPtr)
+{
+  bool ret = false;
+
+  if (dataPtr == m_endPtr) {
+    switch (m_state) {
+    case MODE2RXS_HEADER:
+      processHeader(buffer);
+      break;
+    case MODE2RXS_PAYLOAD:
+      processPayload(buffer);
+      break;
+    case MODE2RXS_CRC:
+      ret = processCRC(buffer);
+      break;
+    default:
+      break;
+    }
+  }
+
+  if ((m_state != MODE2RXS_NONE) && (bitPtr == m_syncPhase))
+    trackLevels(buffer[dataPtr]);
+
+  return ret;
+}
+
+void CMode2Decoder::processHeader(const q15_t* buffer)
+{
+  LOG_MODE2_TRACE("Mode2Decoder: centre/threshold", m_centreVal, m_thresholdVal);
+
+  uint8_t frame[MODE2_HEADER_LENGTH_BYTES + MODE2_HEADER_PARITY_BYTES];
+  samplesToBits(buffer, m_startPtr, m_endPtr, m_centreVal, m_thresholdVal, m_invert, frame);
+
+  bool ok = m_frame.processHeader(frame, m_packet);
+  if (ok) {
+    uint16_t length = m_frame.getPayloadLength();
+    if (length > 0U) {
+      LOG_MODE2_TRACE("Mode2Decoder: header is valid and has a payload", length);
+
+      m_state = MODE2RXS_PAYLOAD;
+
+      length += m_frame.getPayloadParityLength();
+
+      // The payload starts right after the header
+      m_startPtr = m_endPtr;
+
+      m_endPtr = m_startPtr + (length * MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH);
+      if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
+        m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
+    } else {
+      LOG_MODE2_TRACE("Mode2Decoder: header is valid but has no payload");
+
+      m_state = MODE2RXS_CRC;
+
+      // The CRC starts right after the header
+      m_startPtr = m_endPtr;
+
+      m_endPtr = m_startPtr + MODE2_CRC_LENGTH_SAMPLES;
+      if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
+        m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
+    }
+  } else {
+    LOG_MODE2_TRACE("Mode2Decoder: header is invalid");
+    stats.increment(STATS_SYNC_FALSE);
+    reset();
+  }
+}
+
+void CMode2Decoder::processPayload(const q15_t* buffer)
+{
+  LOG_MODE2_TRACE("Mode2Decoder: centre/threshold", m_centreVal, m_thresholdVal);
+
+  uint8_t frame[1023U + (5U * MODE2_PAYLOAD_PARITY_BYTES)];
+  samplesToBits(buffer, m_startPtr, m_endPtr, m_centreVal, m_thresholdVal, m_invert, frame);
+
+  bool ok = m_frame.processPayload(frame, m_packet);
+  if (ok) {
+    LOG_MODE2_TRACE("Mode2Decoder: payload is valid");
+
+    m_state = MODE2RXS_CRC;
+
+    // The CRC starts right after the payload
+    m_startPtr = m_endPtr;
+
+    m_endPtr = m_startPtr + MODE2_CRC_LENGTH_SAMPLES;
+    if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
+      m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
+  } else {
+    LOG_MODE2_INFO("Mode2Decoder: payload is invalid");
+    reset();
+  }
+}
+
+bool CMode2Decoder::processCRC(const q15_t* buffer)
+{
+  uint8_t crc[MODE2_CRC_LENGTH_BYTES];
+  samplesToBits(buffer, m_startPtr, m_endPtr, m_centreVal, m_thresholdVal, m_invert, crc);
+
+  bool ok = m_frame.checkCRC(m_packet, crc);
+  if (ok) {
+    LOG_MODE2_INFO("Mode2Decoder: frame CRC is valid");
+    stats.increment(STATS_MODE2_FRAMES);
+
+    uint16_t length = m_frame.getHeaderLength() + m_frame.getPayloadLength();
+    serial.writeKISSRXData(m_packet, length, m_start);
+  } else {
+    LOG_MODE2_INFO("Mode2Decoder: frame CRC is invalid");
+    stats.increment(STATS_IL2P_CRC_ERRORS);
+  }
+
+  reset();
+
+  return ok;
+}
+
+void CMode2Decoder::initLevels()
+{
+  // The +/-3 levels are half as far again from the centre as the threshold, the +/-1 levels half as far
+  q15_t outer = m_thresholdVal + m_thresholdVal / 2;
+  q15_t inner = m_thresholdVal / 2;
+
+  m_levels[0U] = m_centreVal - outer;
+  m_levels[1U] = m_centreVal - inner;
+  m_levels[2U] = m_centreVal + inner;
+  m_levels[3U] = m_centreVal + outer;
+}
+
+void CMode2Decoder::trackLevels(q15_t sample)
+{
+  // Move the nearest level towards the symbol, then derive the centre and threshold from the levels
+  uint8_t n;
+  if (sample < m_centreVal - m_thresholdVal)
+    n = 0U;
+  else if (sample < m_centreVal)
+    n = 1U;
+  else if (sample < m_centreVal + m_thresholdVal)
+    n = 2U;
+  else
+    n = 3U;
+
+  m_levels[n] += q15_t((q31_t(sample) - q31_t(m_levels[n])) >> LEVEL_TRACK_SHIFT);
+
+  q15_t posThresh = (m_levels[3U] + m_levels[2U]) / 2;
+  q15_t negThresh = (m_levels[1U] + m_levels[0U]) / 2;
+
+  m_centreVal    = (posThresh + negThresh) / 2;
+  m_thresholdVal = posThresh - m_centreVal;
+}
+
+void CMode2Decoder::samplesToBits(const q15_t* buffer, uint16_t startPtr, uint16_t endPtr, q15_t centre, q15_t threshold, bool invert, uint8_t* out)
+{
+  // The dibits are packed into a register and stored a whole byte at a time, the
+  // callers always ask for a whole number of bytes
+  uint16_t offset = 0U;
+  uint8_t  count  = 0U;
+  uint8_t  bits   = 0U;
+
+  while (startPtr != endPtr) {
+    q15_t sample = 0;
+    if (invert)
+      sample = centre - buffer[startPtr];
+    else
+      sample = buffer[startPtr] - centre;
+
+    // -3 = 01, -1 = 00, +1 = 10, +3 = 11
+    uint8_t dibit;
+    if (sample < 0)
+      dibit = (sample < -threshold) ? 0x01U : 0x00U;
+    else
+      dibit = (sample < threshold)  ? 0x02U : 0x03U;
+
+    bits = (bits << 2) | dibit;
+    count++;
+
+    if (count == MODE2_SYMBOLS_PER_BYTE) {
+      out[offset++] = bits;
+      count = 0U;
+      bits  = 0U;
+    }
+
+    startPtr += MODE2_RADIO_SYMBOL_LENGTH;
+    if (startPtr >= MODE2_MAX_LENGTH_SAMPLES)
+      startPtr -= MODE2_MAX_LENGTH_SAMPLES;
+  }
+}
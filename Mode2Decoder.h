@@ -0,0 +1,80 @@
+/*
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(MODE2DECODER_H)
+#define  MODE2DECODER_H
+
+#include "Mode2Defines.h"
+#include "IL2PRX.h"
+
+enum MODE2RX_STATE {
+  MODE2RXS_NONE,
+  MODE2RXS_HEADER,
+  MODE2RXS_PAYLOAD,
+  MODE2RXS_CRC
+};
+
+const uint16_t MODE2_MAX_LENGTH_SAMPLES = (1023U + MODE2_HEADER_LENGTH_BYTES + MODE2_HEADER_PARITY_BYTES + 5U * MODE2_PAYLOAD_PARITY_BYTES + MODE2_CRC_LENGTH_BYTES) * MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH;
+
+class CMode2Decoder {
+public:
+  CMode2Decoder();
+
+  void start(uint16_t syncPtr, uint8_t syncPhase, q15_t centre, q15_t threshold, bool invert, q31_t corr, uint32_t start);
+
+  void reset();
+
+  bool process(const q15_t* buffer, uint16_t dataPtr, uint8_t bitPtr);
+
+  bool isBusy() const;
+
+  uint16_t getSyncPtr() const;
+  q31_t    getCorrelation() const;
+  bool     getInvert() const;
+
+  q15_t    getCentre() const;
+  q15_t    getOuterLevel() const;
+
+  static void samplesToBits(const q15_t* buffer, uint16_t startPtr, uint16_t endPtr, q15_t centre, q15_t threshold, bool invert, uint8_t* out);
+
+private:
+  MODE2RX_STATE        m_state;
+  uint16_t             m_startPtr;
+  uint16_t             m_endPtr;
+  uint16_t             m_syncPtr;
+  uint8_t              m_syncPhase;
+  bool                 m_invert;
+  q31_t                m_corr;
+  uint32_t             m_start;
+  CIL2PRX              m_frame;
+  q15_t                m_levels[4U];
+  q15_t                m_centreVal;
+  q15_t                m_thresholdVal;
+  uint8_t              m_packet[1100U];
+
+  void processHeader(const q15_t* buffer);
+  void processPayload(const q15_t* buffer);
+  bool processCRC(const q15_t* buffer);
+
+  void initLevels();
+  void trackLevels(q15_t sample);
+};
+
+#endif
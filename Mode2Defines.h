@@ -26,6 +26,11 @@ const uint8_t MODE2_RADIO_SYMBOL_LENGTH = 5U;      // At 24 kHz sample rate
 
 const uint8_t MODE2_PREAMBLE_BYTE = 0x77U;
 
+const uint16_t MODE2_OUTER_DEVIATION = 1944U;      // In Hz for the +/-3 symbols, as DMR
+
+// Mode 4 is the mode 2 waveform at twice the symbol rate, processed at 48 kHz
+const uint8_t MODE2_FAST_MODE = 4U;
+
 const uint8_t MODE2_SYMBOLS_PER_BYTE = 4U;
 
 const uint8_t  MODE2_HEADER_PARITY_BYTES   = 2U;
@@ -36,88 +36,139 @@ static q15_t RX_FILTER[] = {  \
       89, 32, -30, -41, -9 };
 const uint16_t RX_FILTER_LEN = 45U;
 
+// The same taps run at 48 kHz for mode 4, so the cutoff doubles to 8640 Hz, doubled for the zero stuffing and padded to an even length
+static q15_t RX_INTERP_FILTER[] = {  \
+      -18, -82, -60, 64, 178, \
+      88, -214, -386, -66, 558, \
+      698, -128, -1204, -1064, 704, \
+      2350, 1412, -2180, -4758, -1660, \
+      7902, 18822, 23636, 18822, 7902, \
+      -1660, -4758, -2180, 1412, 2350, \
+      704, -1064, -1204, -128, 698, \
+      558, -66, -386, -214, 88, \
+      178, 64, -60, -82, -18, \
+      0 };
+const uint16_t RX_INTERP_FILTER_PHASE_LEN = 23U; // phaseLength = numTaps/L
+
 const q15_t SCALING_FACTOR = 21845;      // Q15(0.667)
 
 const uint8_t MAX_SYNC_BIT_ERRS     = 2U;
 const uint8_t MAX_SYNC_SYMBOLS_ERRS = 1U;
 
-const uint8_t BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
-
-#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-
-const uint8_t  NOAVEPTR = 99U;
 const uint16_t NOENDPTR = 9999U;
 
+const uint8_t DC_TRACK_SHIFT = 10U;      // DC tracking time constant of 1024 samples at 24 kHz, about 43ms
+
 CMode2RX::CMode2RX() :
-m_state(MODE2RXS_NONE),
 m_rrc02Filter(),
 m_rrc02State(),
+m_interpFilter(),
+m_interpState(),
+m_rate(1U),
 m_bitBuffer(),
+m_syncSum(),
+m_syncMag(),
+m_dcState(0),
+m_dcLevel(0),
 m_buffer(),
 m_bitPtr(0U),
 m_dataPtr(0U),
-m_startPtr(NOENDPTR),
-m_endPtr(NOENDPTR),
 m_syncPtr(NOENDPTR),
+m_syncPhase(0U),
 m_invert(false),
-m_frame(),
 m_maxCorr(0),
-m_centre(),
 m_centreVal(0),
-m_threshold(),
 m_thresholdVal(0),
 m_countdown(0U),
-m_packet()
+m_decoders()
 {
   ::memset(m_rrc02State, 0x00U, 70U * sizeof(q15_t));
   m_rrc02Filter.numTaps = RX_FILTER_LEN;
   m_rrc02Filter.pState  = m_rrc02State;
   m_rrc02Filter.pCoeffs = RX_FILTER;
+
+  ::memset(m_interpState, 0x00U, 30U * sizeof(q15_t));
+  m_interpFilter.L           = 2U;
+  m_interpFilter.phaseLength = RX_INTERP_FILTER_PHASE_LEN;
+  m_interpFilter.pCoeffs     = RX_INTERP_FILTER;
+  m_interpFilter.pState      = m_interpState;
 }
 
 void CMode2RX::reset()
 {
-  m_state        = MODE2RXS_NONE;
-  m_dataPtr      = 0U;
-  m_bitPtr       = 0U;
+  // The sample ring keeps running so that the sync sums stay in step with it
   m_maxCorr      = 0;
-  m_averagePtr   = NOAVEPTR;
-  m_startPtr     = NOENDPTR;
-  m_endPtr       = NOENDPTR;
   m_syncPtr      = NOENDPTR;
   m_centreVal    = 0;
   m_thresholdVal = 0;
   m_countdown    = 0U;
   m_invert       = false;
+
+  for (uint8_t i = 0U; i < MODE2_RX_DECODERS; i++)
+    m_decoders[i].reset();
 }
 
 void CMode2RX::samples(q15_t* samples, uint8_t length)
 {
-  q15_t vals[RX_BLOCK_SIZE];
-  ::arm_fir_fast_q15(&m_rrc02Filter, samples, vals, RX_BLOCK_SIZE);
+  // Mode 4 is upsampled to 48 kHz to keep the five samples per symbol of mode 2
+  uint8_t rate = (m_mode == MODE2_FAST_MODE) ? 2U : 1U;
+  // The DC tracking runs at the interpolated rate, so it takes twice the samples in mode 4 for the same time
+  uint8_t dcShift = DC_TRACK_SHIFT + rate - 1U;
+
+  if (rate != m_rate) {
+    m_rate    = rate;
+    m_dcState = q31_t(m_dcLevel) << dcShift;
+    reset();
+  }
+
+  q15_t vals[RX_BLOCK_SIZE * 2U];
+  if (m_rate == 2U)
+    ::arm_fir_interpolate_q15(&m_interpFilter, samples, vals, RX_BLOCK_SIZE);
+  else
+    ::arm_fir_fast_q15(&m_rrc02Filter, samples, vals, RX_BLOCK_SIZE);
+
+  length *= m_rate;
+
+  bool decode = false;
+  for (uint8_t i = 0U; i < MODE2_RX_DECODERS; i++) {
+    if (m_decoders[i].isBusy())
+      decode = true;
+  }
 
   for (uint8_t i = 0U; i < length; i++) {
-    q15_t sample = vals[i];
+    // The frequency offset appears as DC, it is tracked between frames over the balanced preamble
+    // and held while decoding so that the decoders' own level tracking sees a fixed reference
+    if (!decode) {
+      m_dcState += q31_t(vals[i]) - q31_t(m_dcLevel);
+      m_dcLevel  = q15_t(m_dcState >> dcShift);
+    }
+
+    q15_t sample = q15_t(__SSAT(q31_t(vals[i]) - q31_t(m_dcLevel), 16));
 
     m_bitBuffer[m_bitPtr] <<= 1;
     if (sample < 0)
       m_bitBuffer[m_bitPtr] |= 0x01U;
 
+    // Slide the running sum and magnitude of the last sync length of symbols in this phase
+    uint16_t oldPtr = m_dataPtr + MODE2_MAX_LENGTH_SAMPLES - MODE2_SYNC_LENGTH_SAMPLES;
+    if (oldPtr >= MODE2_MAX_LENGTH_SAMPLES)
+      oldPtr -= MODE2_MAX_LENGTH_SAMPLES;
+
+    q15_t old = m_buffer[oldPtr];
+    m_syncSum[m_bitPtr] += q31_t(sample) - q31_t(old);
+    m_syncMag[m_bitPtr] += ((sample < 0) ? -q31_t(sample) : q31_t(sample)) - ((old < 0) ? -q31_t(old) : q31_t(old));
+
     m_buffer[m_dataPtr] = sample;
 
-    switch (m_state) {
-    case MODE2RXS_HEADER:
-      processHeader(sample);
-      break;
-    case MODE2RXS_PAYLOAD:
-      processPayload(sample);
-      break;
-    case MODE2RXS_CRC:
-      processCRC(sample);
-      break;
-    default:
-      processNone(sample);
-      break;
+    // Keep looking for a sync while decoding, so a false lock cannot hide a real frame
+    processSync();
+
+    for (uint8_t j = 0U; j < MODE2_RX_DECODERS; j++) {
+      if (m_decoders[j].isBusy()) {
+        bool ok = m_decoders[j].process(m_buffer, m_dataPtr, m_bitPtr);
+        if (ok)
+          reportOffset(m_decoders[j]);
+      }
     }
 
     m_dataPtr++;
@@ -128,17 +179,42 @@ void CMode2RX::samples(q15_t* samples, uint8_t length)
     if (m_bitPtr >= MODE2_RADIO_SYMBOL_LENGTH)
       m_bitPtr = 0U;
   }
+
+  decode = false;
+  for (uint8_t i = 0U; i < MODE2_RX_DECODERS; i++) {
+    if (m_decoders[i].isBusy())
+      decode = true;
+  }
+
+  io.setDecode(decode);
 }
 
-void CMode2RX::processNone(q15_t sample)
+void CMode2RX::reportOffset(const CMode2Decoder& decoder)
+{
+  q15_t outer = decoder.getOuterLevel();
+  if (outer <= 0)
+    return;
+
+  // The outer symbol level corresponds to the +/-3 symbol deviation, which is the same at both symbol rates
+  q31_t centre = q31_t(m_dcLevel) + q31_t(decoder.getCentre());
+  int16_t offset = int16_t((centre * q31_t(MODE2_OUTER_DEVIATION)) / q31_t(outer));
+
+  // An inverted signal moves the other way for the same frequency offset
+  if (decoder.getInvert())
+    offset = -offset;
+
+  LOG_MODE2_INFO("Mode2RX: frequency offset in Hz", offset);
+
+  serial.writeKISSFreqOffset(offset);
+}
+
+void CMode2RX::processSync()
 {
   bool ret = correlateSync();
   if (ret) {
-    // On the first sync, start the countdown to the state change
-    if (m_countdown == 0U) {
-      m_averagePtr = NOAVEPTR;
-      m_countdown  = 3U;
-    }
+    // On the first sync, start the countdown to the decoder start
+    if (m_countdown == 0U)
+      m_countdown = 3U;
   }
 
   if (m_countdown > 0U)
@@ -146,298 +222,128 @@ void CMode2RX::processNone(q15_t sample)
 
   if (m_countdown == 1U) {
     if (m_thresholdVal >= 50) {
-      DEBUG5("Mode2RX: sync found pos/centre/threshold/invert", m_syncPtr, m_centreVal, m_thresholdVal, m_invert ? 1 : 0);
-
-      io.setDecode(true);
-
-      m_state     = MODE2RXS_HEADER;
-      m_countdown = 0U;
-    } else {
-      reset();
+      LOG_MODE2_TRACE("Mode2RX: sync found pos/centre/threshold/invert", m_syncPtr, m_centreVal, m_thresholdVal, m_invert ? 1 : 0);
+      startDecoder();
     }
+
+    m_maxCorr   = 0;
+    m_syncPtr   = NOENDPTR;
+    m_countdown = 0U;
   }
 }
 
-void CMode2RX::processHeader(q15_t sample)
+void CMode2RX::startDecoder()
 {
-  if (m_dataPtr == m_endPtr) {
-    calculateLevels(m_startPtr, m_endPtr);
-
-    uint8_t frame[MODE2_HEADER_LENGTH_BYTES + MODE2_HEADER_PARITY_BYTES];
-    samplesToBits(m_startPtr, m_endPtr, frame);
-
-    bool ok = m_frame.processHeader(frame, m_packet);
-    if (ok) {
-      uint16_t length = m_frame.getPayloadLength();
-      if (length > 0U) {
-        DEBUG2("Mode2RX: header is valid and has a payload", length);
-
-        m_state = MODE2RXS_PAYLOAD;
-
-        length += m_frame.getPayloadParityLength();
-
-        // The payload starts right after the header
-        m_startPtr = m_endPtr;
+  CMode2Decoder* decoder = NULL;
 
-        m_endPtr = m_startPtr + (length * MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH);
-        if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
-          m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
-      } else {
-        DEBUG1("Mode2RX: header is valid but has no payload");
-
-        m_state = MODE2RXS_CRC;
+  for (uint8_t i = 0U; i < MODE2_RX_DECODERS; i++) {
+    if (!m_decoders[i].isBusy()) {
+      if (decoder == NULL)
+        decoder = &m_decoders[i];
+      continue;
+    }
 
-        // The CRC starts right after the header
-        m_startPtr = m_endPtr;
+    // A sync within a symbol of one already being decoded is the same frame
+    uint16_t diff = (m_syncPtr >= m_decoders[i].getSyncPtr()) ? (m_syncPtr - m_decoders[i].getSyncPtr()) : (m_decoders[i].getSyncPtr() - m_syncPtr);
+    if ((diff < MODE2_RADIO_SYMBOL_LENGTH) || (diff > (MODE2_MAX_LENGTH_SAMPLES - MODE2_RADIO_SYMBOL_LENGTH)))
+      return;
+  }
 
-        m_endPtr = m_startPtr + MODE2_CRC_LENGTH_SAMPLES;
-        if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
-          m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
+  // With every decoder busy, the weakest one gives way to a stronger sync
+  if (decoder == NULL) {
+    for (uint8_t i = 0U; i < MODE2_RX_DECODERS; i++) {
+      if (m_decoders[i].getCorrelation() < m_maxCorr) {
+        if ((decoder == NULL) || (m_decoders[i].getCorrelation() < decoder->getCorrelation()))
+          decoder = &m_decoders[i];
       }
-    } else {
-      DEBUG1("Mode2RX: header is invalid");
-      io.setDecode(false);
-      reset();
     }
-  }
-}
-
-void CMode2RX::processPayload(q15_t sample)
-{
-  if (m_dataPtr == m_endPtr) {
-    calculateLevels(m_startPtr, m_endPtr);
-
-    uint8_t frame[1023U + (5U * MODE2_PAYLOAD_PARITY_BYTES)];
-    samplesToBits(m_startPtr, m_endPtr, frame);
-
-    bool ok = m_frame.processPayload(frame, m_packet);
-    if (ok) {
-      DEBUG1("Mode2RX: payload is valid");
 
-      m_state = MODE2RXS_CRC;
-
-      // The CRC starts right after the payload
-      m_startPtr = m_endPtr;
-
-      m_endPtr = m_startPtr + MODE2_CRC_LENGTH_SAMPLES;
-      if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
-        m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
-    } else {
-      DEBUG1("Mode2RX: payload is invalid");
-      io.setDecode(false);
-      reset();
+    if (decoder == NULL) {
+      LOG_MODE2_INFO("Mode2RX: no free decoder for the sync");
+      return;
     }
+
+    LOG_MODE2_TRACE("Mode2RX: replacing a weaker decoder", decoder->getCorrelation());
   }
-}
 
-void CMode2RX::processCRC(q15_t sample)
-{
-  if (m_dataPtr == m_endPtr) {
-    uint8_t crc[MODE2_CRC_LENGTH_BYTES];
-    samplesToBits(m_startPtr, m_endPtr, crc);
-
-    bool ok = m_frame.checkCRC(m_packet, crc);
-    if (ok) {
-      DEBUG1("Mode2RX: frame CRC is valid");
-
-      uint16_t length = m_frame.getHeaderLength() + m_frame.getPayloadLength();
-      serial.writeKISSData(KISS_TYPE_DATA, m_packet, length);
-    } else {
-      DEBUG1("Mode2RX: frame CRC is invalid");
-    }
+  // The sync is some way behind the newest sample, mode 4 has two buffer samples per received sample
+  uint16_t behind = (m_dataPtr >= m_syncPtr) ? (m_dataPtr - m_syncPtr) : (m_dataPtr + MODE2_MAX_LENGTH_SAMPLES - m_syncPtr);
+  uint32_t start  = io.getRXSampleIndex() - behind / m_rate;
 
-    io.setDecode(false);
-    reset();
-  }
+  decoder->start(m_syncPtr, m_syncPhase, m_centreVal, m_thresholdVal, m_invert, m_maxCorr, start);
 }
 
 bool CMode2RX::correlateSync()
 {
-  uint8_t n1 = countBits16(m_bitBuffer[m_bitPtr] ^  MODE2_SYNC_SYMBOLS);
-  uint8_t n2 = countBits16(m_bitBuffer[m_bitPtr] ^ ~MODE2_SYNC_SYMBOLS);
+  uint16_t diff = m_bitBuffer[m_bitPtr] ^ MODE2_SYNC_SYMBOLS;
+  bool invert = false;
 
-  if ((n1 <= MAX_SYNC_SYMBOLS_ERRS) || (n2 <= MAX_SYNC_SYMBOLS_ERRS)) {
-    uint16_t ptr = m_dataPtr + MODE2_MAX_LENGTH_SAMPLES - MODE2_SYNC_LENGTH_SAMPLES;
-    if (ptr >= MODE2_MAX_LENGTH_SAMPLES)
-      ptr -= MODE2_MAX_LENGTH_SAMPLES;
+  uint8_t n = countBits16(diff);
+  if (n > MAX_SYNC_SYMBOLS_ERRS) {
+    diff   = ~diff;
+    invert = true;
 
-    q31_t corr = 0;
-    q15_t min  =  16000;
-    q15_t max  = -16000;
-
-    for (uint8_t i = 0U; i < MODE2_SYNC_LENGTH_SYMBOLS; i++) {
-      q15_t val = m_buffer[ptr];
+    n = countBits16(diff);
+    if (n > MAX_SYNC_SYMBOLS_ERRS)
+      return false;
+  }
 
-      if (val > max)
-        max = val;
-      if (val < min)
-        min = val;
-
-      switch (MODE2_SYNC_SYMBOLS_VALUES[i]) {
-      case +3:
-        corr -= (val + val + val);
-        break;
-      case +1:
-        corr -= val;
-        break;
-      case -1:
-        corr += val;
-        break;
-      default:  // -3
-        corr += (val + val + val);
-        break;
-      }
+  // All of the sync symbols are +/-3, so the correlation is the running magnitude
+  // less twice the magnitude of any symbols whose sign disagrees with the sync
+  q31_t corr = m_syncMag[m_bitPtr];
 
-      ptr += MODE2_RADIO_SYMBOL_LENGTH;
-      if (ptr >= MODE2_MAX_LENGTH_SAMPLES)
-        ptr -= MODE2_MAX_LENGTH_SAMPLES;
+  uint16_t ptr = m_dataPtr;
+  while (diff != 0U) {
+    if ((diff & 0x01U) == 0x01U) {
+      q15_t val = m_buffer[ptr];
+      corr -= (val < 0) ? -2 * q31_t(val) : 2 * q31_t(val);
     }
 
-    if ((corr > m_maxCorr) || (-corr > m_maxCorr)) {
-      if (m_averagePtr == NOAVEPTR) {
-        m_centreVal = (max + min) / 2;
+    diff >>= 1;
 
-        q31_t v1 = (max - m_centreVal) * SCALING_FACTOR;
-        m_thresholdVal = q15_t(v1 >> 15);
-      }
-
-      m_invert = (-corr > m_maxCorr);
-
-      uint16_t startPtr = m_dataPtr + MODE2_MAX_LENGTH_SAMPLES - MODE2_SYNC_LENGTH_SAMPLES + MODE2_RADIO_SYMBOL_LENGTH;
-      if (startPtr >= MODE2_MAX_LENGTH_SAMPLES)
-        startPtr -= MODE2_MAX_LENGTH_SAMPLES;
-
-      uint16_t endPtr = m_dataPtr;
-
-      uint8_t sync[MODE2_SYNC_LENGTH_BYTES];
-      samplesToBits(startPtr, endPtr, sync);
-
-      uint8_t errs = 0U;
-      for (uint8_t i = 0U; i < MODE2_SYNC_LENGTH_BYTES; i++)
-        errs += countBits8(sync[i] ^ MODE2_SYNC_BYTES[i]);
-
-      if (errs <= MAX_SYNC_BIT_ERRS) {
-        DEBUG6("Mode2RX: valid sync vector", corr, m_dataPtr, n1, n2, errs);
-
-        m_maxCorr = m_invert ? -corr : corr;
-        m_syncPtr = m_dataPtr;
-
-        // The header starts right after the sync vector
-        m_startPtr = m_dataPtr + MODE2_RADIO_SYMBOL_LENGTH;
-        if (m_startPtr >= MODE2_MAX_LENGTH_SAMPLES)
-          m_startPtr -= MODE2_MAX_LENGTH_SAMPLES;
-
-        m_endPtr = m_startPtr + MODE2_HEADER_LENGTH_SAMPLES + MODE2_HEADER_PARITY_SAMPLES;
-        if (m_endPtr >= MODE2_MAX_LENGTH_SAMPLES)
-          m_endPtr -= MODE2_MAX_LENGTH_SAMPLES;
-
-        return true;
-      }
-    }
+    ptr += MODE2_MAX_LENGTH_SAMPLES - MODE2_RADIO_SYMBOL_LENGTH;
+    if (ptr >= MODE2_MAX_LENGTH_SAMPLES)
+      ptr -= MODE2_MAX_LENGTH_SAMPLES;
   }
 
-  return false;
-}
+  corr *= 3;
 
-void CMode2RX::calculateLevels(uint16_t startPtr, uint16_t endPtr)
-{
-  q15_t maxPos = -16000;
-  q15_t minPos =  16000;
-  q15_t maxNeg =  16000;
-  q15_t minNeg = -16000;
-
-  while (startPtr != endPtr) {
-    q15_t sample = m_buffer[startPtr];
-
-    if (sample > 0) {
-      if (sample > maxPos)
-        maxPos = sample;
-      if (sample < minPos)
-        minPos = sample;
-    } else {
-      if (sample < maxNeg)
-        maxNeg = sample;
-      if (sample > minNeg)
-        minNeg = sample;
-    }
+  if (corr > m_maxCorr) {
+    // The sync vector has as many +3 as -3 symbols, so its mean is the centre
+    q15_t centre = q15_t(m_syncSum[m_bitPtr] / MODE2_SYNC_LENGTH_SYMBOLS);
 
-    startPtr += MODE2_RADIO_SYMBOL_LENGTH;
+    q31_t v1 = (m_syncMag[m_bitPtr] / MODE2_SYNC_LENGTH_SYMBOLS) * SCALING_FACTOR;
+    q15_t threshold = q15_t(v1 >> 15);
+
+    uint16_t startPtr = m_dataPtr + MODE2_MAX_LENGTH_SAMPLES - MODE2_SYNC_LENGTH_SAMPLES + MODE2_RADIO_SYMBOL_LENGTH;
     if (startPtr >= MODE2_MAX_LENGTH_SAMPLES)
       startPtr -= MODE2_MAX_LENGTH_SAMPLES;
-  }
-
-  q15_t posThresh = (maxPos + minPos) / 2;
-  q15_t negThresh = (maxNeg + minNeg) / 2;
-
-  q15_t centre = (posThresh + negThresh) / 2;
-
-  q15_t threshold = posThresh - centre;
-
-  DEBUG5("Mode2RX: pos/neg/centre/threshold", posThresh, negThresh, centre, threshold);
 
-  if (m_averagePtr == NOAVEPTR) {
-    for (uint8_t i = 0U; i < 16U; i++) {
-      m_centre[i]    = centre;
-      m_threshold[i] = threshold;
-    }
-
-    m_averagePtr = 0U;
-  } else {
-    m_centre[m_averagePtr]    = centre;
-    m_threshold[m_averagePtr] = threshold;
+    // The last symbol of the sync vector is the one just received
+    uint16_t endPtr = m_dataPtr + MODE2_RADIO_SYMBOL_LENGTH;
+    if (endPtr >= MODE2_MAX_LENGTH_SAMPLES)
+      endPtr -= MODE2_MAX_LENGTH_SAMPLES;
 
-    m_averagePtr++;
-    if (m_averagePtr >= 16U)
-      m_averagePtr = 0U;
-  }
+    uint8_t sync[MODE2_SYNC_LENGTH_BYTES];
+    CMode2Decoder::samplesToBits(m_buffer, startPtr, endPtr, centre, threshold, invert, sync);
 
-  m_centreVal = 0;
-  m_thresholdVal = 0;
+    uint8_t errs = 0U;
+    for (uint8_t i = 0U; i < MODE2_SYNC_LENGTH_BYTES; i++)
+      errs += countBits8(sync[i] ^ MODE2_SYNC_BYTES[i]);
 
-  for (uint8_t i = 0U; i < 16U; i++) {
-    m_centreVal    += m_centre[i];
-    m_thresholdVal += m_threshold[i];
-  }
+    if (errs <= MAX_SYNC_BIT_ERRS) {
+      LOG_MODE2_TRACE("Mode2RX: valid sync vector", invert ? -corr : corr, m_dataPtr, n, errs);
 
-  m_centreVal    /= 16;
-  m_thresholdVal /= 16;
-}
+      m_maxCorr      = corr;
+      m_syncPtr      = m_dataPtr;
+      m_syncPhase    = m_bitPtr;
+      m_centreVal    = centre;
+      m_thresholdVal = threshold;
+      m_invert       = invert;
 
-void CMode2RX::samplesToBits(uint16_t startPtr, uint16_t endPtr, uint8_t* buffer)
-{
-  uint16_t offset = 0U;
-
-  while (startPtr != endPtr) {
-    q15_t sample = 0;
-    if (m_invert)
-      sample = -m_buffer[startPtr] - m_centreVal;
-    else
-      sample = m_buffer[startPtr] - m_centreVal;
-
-    if (sample < -m_thresholdVal) {
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-    } else if (sample < 0) {
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-    } else if (sample < m_thresholdVal) {
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-      WRITE_BIT1(buffer, offset, false);
-      offset++;
-    } else {
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
-      WRITE_BIT1(buffer, offset, true);
-      offset++;
+      return true;
     }
-
-    startPtr += MODE2_RADIO_SYMBOL_LENGTH;
-    if (startPtr >= MODE2_MAX_LENGTH_SAMPLES)
-      startPtr -= MODE2_MAX_LENGTH_SAMPLES;
   }
+
+  return false;
 }
@@ -22,16 +22,9 @@
 #define  MODE2RX_H
 
 #include "Mode2Defines.h"
-#include "IL2PRX.h"
+#include "Mode2Decoder.h"
 
-enum MODE2RX_STATE {
-  MODE2RXS_NONE,
-  MODE2RXS_HEADER,
-  MODE2RXS_PAYLOAD,
-  MODE2RXS_CRC
-};
-
-const uint16_t MODE2_MAX_LENGTH_SAMPLES = (1023U + MODE2_HEADER_LENGTH_BYTES + MODE2_HEADER_PARITY_BYTES + 5U * MODE2_PAYLOAD_PARITY_BYTES + MODE2_CRC_LENGTH_BYTES) * MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH;
+const uint8_t MODE2_RX_DECODERS = 3U;
 
 class CMode2RX {
 public:
@@ -42,35 +35,33 @@ public:
   void samples(q15_t* samples, uint8_t length);
 
 private:
-  MODE2RX_STATE        m_state;
   arm_fir_instance_q15 m_rrc02Filter;
   q15_t                m_rrc02State[70U];         // NoTaps + BlockSize - 1, 42 + 20 - 1 plus some spare
+  arm_fir_interpolate_instance_q15 m_interpFilter;
+  q15_t                m_interpState[30U];        // PhaseLength + BlockSize - 1, 23 + 2 - 1 plus some spare
+  uint8_t              m_rate;
   uint16_t             m_bitBuffer[MODE2_RADIO_SYMBOL_LENGTH];
+  q31_t                m_syncSum[MODE2_RADIO_SYMBOL_LENGTH];
+  q31_t                m_syncMag[MODE2_RADIO_SYMBOL_LENGTH];
+  q31_t                m_dcState;
+  q15_t                m_dcLevel;
   q15_t                m_buffer[MODE2_MAX_LENGTH_SAMPLES];
   uint16_t             m_bitPtr;
   uint16_t             m_dataPtr;
-  uint16_t             m_startPtr;
-  uint16_t             m_endPtr;
   uint16_t             m_syncPtr;
+  uint8_t              m_syncPhase;
   bool                 m_invert;
-  CIL2PRX              m_frame;
   q31_t                m_maxCorr;
-  q15_t                m_centre[16U];
   q15_t                m_centreVal;
-  q15_t                m_threshold[16U];
   q15_t                m_thresholdVal;
-  uint8_t              m_averagePtr;
   uint8_t              m_countdown;
-  uint8_t              m_packet[1100U];
+  CMode2Decoder        m_decoders[MODE2_RX_DECODERS];
 
-  void processNone(q15_t sample);
-  void processHeader(q15_t sample);
-  void processPayload(q15_t sample);
-  void processCRC(q15_t sample);
+  void processSync();
 
   bool correlateSync();
-  void calculateLevels(uint16_t startPtr, uint16_t endPtr);
-  void samplesToBits(uint16_t startPtr, uint16_t endPtr, uint8_t* buffer);
+  void startDecoder();
+  void reportOffset(const CMode2Decoder& decoder);
 };
 
 #endif
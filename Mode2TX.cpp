@@ -33,13 +33,25 @@ static q15_t TX_PULSE_FILTER[] = {  \
       0, 0, 0, 0, 0, \
       0, 0, 0, 0, 0, \
       0, 0, 0, 0, 0 };
-const uint16_t TX_PULSE_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
+
+// Only three polyphase branches of the pulse filter have non-zero taps, starting with this one
+const uint8_t MOD_FIRST_BRANCH = 3U;
+const uint8_t MOD_WINDOW_LEN   = 3U;
+
+const uint8_t MOD_SYMBOL_VALUES = 5U;
+const uint8_t MOD_WINDOWS       = MOD_SYMBOL_VALUES * MOD_SYMBOL_VALUES * MOD_SYMBOL_VALUES;
 
 const q15_t LEVELA =  1362;
 const q15_t LEVELB =  454;
 const q15_t LEVELC = -454;
 const q15_t LEVELD = -1362;
 
+// Silence, followed by the levels for the dibits 00, 01, 10, and 11
+const q15_t MOD_SYMBOL_LEVELS[] = {0, LEVELC, LEVELD, LEVELB, LEVELA};
+const uint8_t MOD_SILENCE = 0U;
+
+const uint8_t SPACER_LENGTH = 10U;
+
 const uint8_t BIT_MASK_TABLE1[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
 
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE1[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE1[(i)&7])
@@ -53,41 +65,27 @@ const uint8_t BIT_MASK_TABLE2[] = { 0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x
 CMode2TX::CMode2TX() :
 m_fifo(3000U),
 m_playOut(0U),
-m_modFilter(),
-m_modState(),
+m_modTable(),
+m_modWindow(0U),
+m_modPhase(0U),
 m_frame(),
 m_level(MODE2_TX_LEVEL * 128),
 m_txDelay((TX_DELAY / 10U) * 12U),
 m_txTail((TX_TAIL / 10U) * 12U),
-m_tokens()
+m_burstWindow((MODE2_BURST_WINDOW / 10U) * 12U),
+m_hold(0U),
+m_tokens(),
+m_fifoOut(0U)
 {
-  ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
+  createModTable();
 
-  m_modFilter.L           = MODE2_RADIO_SYMBOL_LENGTH;
-  m_modFilter.phaseLength = TX_PULSE_FILTER_PHASE_LEN;
-  m_modFilter.pCoeffs     = TX_PULSE_FILTER;
-  m_modFilter.pState      = m_modState;
+  m_frame.setMaxFEC(MODE2_MAX_FEC == 1);
 }
 
 void CMode2TX::process()
 {
-  if (!m_duplex) {
-    // Nothing left to transmit, send the packet tokens back
-    if (!m_tx && m_fifo.getData() == 0U) {
-      m_tokens.reset();
-      uint16_t token;
-      while (m_tokens.next(token))
-        serial.writeKISSAck(token);
-      m_tokens.clear();
-    }
-  } else {
-    // Send the tokens back immediately as the packets can be transmitted immediately too
-    m_tokens.reset();
-    uint16_t token;
-    while (m_tokens.next(token))
-      serial.writeKISSAck(token);
-    m_tokens.clear();
-  }
+  // Send back the tokens of the packets that have been transmitted
+  m_tokens.process();
 
   // Transmit is off but we have data to send
   if (!m_tx && m_fifo.getData() > 0U) {
@@ -96,6 +94,13 @@ void CMode2TX::process()
       return;
   }
 
+  // Mode 4 sends twice as many bytes in the same time
+  uint8_t rate = getRate();
+
+  // A packet arriving during the trailer of a burst cuts it short
+  if ((m_burstWindow > 0U) && (m_fifo.getData() > 0U))
+    m_playOut = 0U;
+
   // Are we sending the trailer?
   if (m_playOut > 0U) {
     uint16_t space = io.getSpace();
@@ -113,104 +118,186 @@ void CMode2TX::process()
   }
 
   if (m_fifo.getData() > 0U) {
+    m_hold = 0U;
+
     uint16_t space = io.getSpace();
     while (space > (MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH)) {
+      m_tokens.update(m_fifoOut);
+
       uint8_t c = 0U;
       m_fifo.get(c);
+      m_fifoOut++;
 
       writeByte(c);
 
       space -= MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH;
 
       if (m_fifo.getData() == 0U) {
-        m_playOut = m_txTail;
+        m_tokens.update(m_fifoOut);
+
+        // The trailer of a burst starts with preamble for the burst window
+        if (m_burstWindow > 0U)
+          m_hold = m_burstWindow * rate;
+        else
+          m_playOut = m_txTail * rate;
         return;
       }
     }
+
+    return;
   }
+
+  // Send preamble while waiting for another packet to join the burst, then any rest of the trailer
+  if (m_hold > 0U) {
+    uint16_t space = io.getSpace();
+    while (space > (MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH)) {
+      writeByte(MODE2_PREAMBLE_BYTE);
+
+      space -= MODE2_SYMBOLS_PER_BYTE * MODE2_RADIO_SYMBOL_LENGTH;
+      m_hold--;
+
+      if (m_hold == 0U) {
+        m_playOut = (m_txTail > m_burstWindow) ? ((m_txTail - m_burstWindow) * rate) : 0U;
+        break;
+      }
+    }
+  }
+}
+
+void CMode2TX::flushTokens()
+{
+  m_tokens.flush();
 }
 
 uint8_t CMode2TX::writeData(const uint8_t* data, uint16_t length)
 {
+  uint16_t spacer = getSpacerLength();
+
+  uint16_t needed = MODE2_SYNC_LENGTH_BYTES + m_frame.getMaxLength(length) + spacer;
+
   uint16_t space = m_fifo.getSpace();
-  if (space < (length + MODE2_SYNC_LENGTH_BYTES)) {
-    DEBUG1("Mode2TX: no space for the packet");
+  if (space < needed) {
+    LOG_MODE2_ERROR("Mode2TX: no space for the packet");
     return 5U;
   }
 
-  // Add the preamble symbols
+  // Add the preamble symbols, as many as will fit alongside the packet
   if (!m_tx && (m_fifo.getData() == 0U)) {
-    for (uint16_t i = 0U; i < m_txDelay; i++)
-      m_fifo.put(MODE2_PREAMBLE_BYTE);
+    uint16_t preamble = m_txDelay * getRate();
+    if (preamble > (space - needed))
+      preamble = space - needed;
+
+    m_fifo.fill(MODE2_PREAMBLE_BYTE, preamble);
   }
 
   // Add the IL2P sync vector
-  for (uint8_t i = 0U; i < MODE2_SYNC_LENGTH_BYTES; i++)
-    m_fifo.put(MODE2_SYNC_BYTES[i]);
+  m_fifo.put(MODE2_SYNC_BYTES, MODE2_SYNC_LENGTH_BYTES);
 
-  uint8_t buffer[2000U];
-  uint16_t len = m_frame.process(data, length, buffer);
-
-  for (uint16_t i = 0U; i < len; i++)
-    m_fifo.put(buffer[i]);
+  // The frame is encoded straight into the FIFO
+  m_frame.process(data, length, m_fifo);
 
   // Insert some spacer
-  for (uint8_t i = 0U; i < 10U; i++)
-    m_fifo.put(MODE2_PREAMBLE_BYTE);
+  m_fifo.fill(MODE2_PREAMBLE_BYTE, spacer);
 
   return 0U;
 }
 
 uint8_t CMode2TX::writeDataAck(uint16_t token, const uint8_t* data, uint16_t length)
 {
-  m_tokens.add(token);
+  if (!m_tokens.hasSpace()) {
+    LOG_MODE2_ERROR("Mode2TX: no space for the token");
+    return 5U;
+  }
+
+  // The packet runs from the end of the queue up to its spacer, its preamble counting as part of it
+  uint32_t start = m_fifoOut + m_fifo.getData();
 
-  return writeData(data, length);
+  uint8_t ret = writeData(data, length);
+  if (ret != 0U)
+    return ret;
+
+  uint32_t end = m_fifoOut + m_fifo.getData() - getSpacerLength();
+
+  m_tokens.add(token, start, end);
+
+  return 0U;
 }
 
 void CMode2TX::writeByte(uint8_t c)
 {
-  q15_t inBuffer[MODE2_SYMBOLS_PER_BYTE];
+  q15_t outBuffer[MODE2_RADIO_SYMBOL_LENGTH * MODE2_SYMBOLS_PER_BYTE];
 
-  const uint8_t MASK = 0xC0U;
+  uint8_t n = 0U;
+  for (uint8_t i = 0U; i < MODE2_SYMBOLS_PER_BYTE; i++, c <<= 2)
+    n += writeSymbol((c >> 6) + 1U, outBuffer + n);
 
-  for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-    q15_t value = 0;
+  io.write(outBuffer, n);
+}
 
-    switch (c & MASK) {
-      case 0xC0U:
-        value = LEVELA;
-        break;
-      case 0x80U:
-        value = LEVELB;
-        break;
-      case 0x00U:
-        value = LEVELC;
-        break;
-      default:
-        value = LEVELD;
-        break;
-    }
+void CMode2TX::writeSilence()
+{
+  q15_t outBuffer[MODE2_RADIO_SYMBOL_LENGTH * MODE2_SYMBOLS_PER_BYTE];
+
+  uint8_t n = 0U;
+  for (uint8_t i = 0U; i < MODE2_SYMBOLS_PER_BYTE; i++)
+    n += writeSymbol(MOD_SILENCE, outBuffer + n);
+
+  io.write(outBuffer, n);
+}
+
+uint8_t CMode2TX::writeSymbol(uint8_t value, q15_t* out)
+{
+  m_modWindow = (m_modWindow % (MOD_WINDOWS / MOD_SYMBOL_VALUES)) * MOD_SYMBOL_VALUES + value;
 
-    q31_t res = value * m_level;
+  const q15_t* in = m_modTable + m_modWindow * MODE2_RADIO_SYMBOL_LENGTH;
 
-    inBuffer[i] = q15_t(__SSAT((res >> 15), 16));
+  if (m_mode != MODE2_FAST_MODE) {
+    ::memcpy(out, in, MODE2_RADIO_SYMBOL_LENGTH * sizeof(q15_t));
+    return MODE2_RADIO_SYMBOL_LENGTH;
   }
 
-  q15_t outBuffer[MODE2_RADIO_SYMBOL_LENGTH * 4U];
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, MODE2_SYMBOLS_PER_BYTE);
+  // Mode 4 is shaped at 48 kHz and every other sample is kept, so the symbols alternate between three and two samples
+  uint8_t n = 0U;
+  for (uint8_t j = m_modPhase; j < MODE2_RADIO_SYMBOL_LENGTH; j += 2U)
+    out[n++] = in[j];
+
+  m_modPhase ^= 0x01U;
 
-  io.write(outBuffer, MODE2_RADIO_SYMBOL_LENGTH * MODE2_SYMBOLS_PER_BYTE);
+  return n;
 }
 
-void CMode2TX::writeSilence()
+uint8_t CMode2TX::getRate() const
+{
+  return (m_mode == MODE2_FAST_MODE) ? 2U : 1U;
+}
+
+// Packets in a burst are separated only by their sync vectors
+uint16_t CMode2TX::getSpacerLength() const
+{
+  return (m_burstWindow > 0U) ? 0U : SPACER_LENGTH;
+}
+
+void CMode2TX::createModTable()
 {
-  q15_t inBuffer[MODE2_SYMBOLS_PER_BYTE] = {0, 0, 0, 0};
-  q15_t outBuffer[MODE2_RADIO_SYMBOL_LENGTH * 4U];
+  // The output of the pulse filter for every window of symbols, oldest first, at the current level
+  for (uint8_t window = 0U; window < MOD_WINDOWS; window++) {
+    q15_t values[MOD_WINDOW_LEN];
+
+    uint8_t n = window;
+    for (uint8_t i = 0U; i < MOD_WINDOW_LEN; i++) {
+      q31_t res = MOD_SYMBOL_LEVELS[n % MOD_SYMBOL_VALUES] * m_level;
+      values[MOD_WINDOW_LEN - 1U - i] = q15_t(__SSAT((res >> 15), 16));
+      n /= MOD_SYMBOL_VALUES;
+    }
 
-  ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, MODE2_SYMBOLS_PER_BYTE);
+    for (uint8_t j = 0U; j < MODE2_RADIO_SYMBOL_LENGTH; j++) {
+      q63_t sum = 0;
+      for (uint8_t i = 0U; i < MOD_WINDOW_LEN; i++)
+        sum += q31_t(values[i]) * TX_PULSE_FILTER[(MOD_FIRST_BRANCH + i) * MODE2_RADIO_SYMBOL_LENGTH + MODE2_RADIO_SYMBOL_LENGTH - 1U - j];
 
-  io.write(outBuffer, MODE2_RADIO_SYMBOL_LENGTH * MODE2_SYMBOLS_PER_BYTE);
+      m_modTable[window * MODE2_RADIO_SYMBOL_LENGTH + j] = q15_t(__SSAT((sum >> 15), 16));
+    }
+  }
 }
 
 void CMode2TX::setTXDelay(uint8_t value)
@@ -226,4 +313,11 @@ void CMode2TX::setTXTail(uint8_t value)
 void CMode2TX::setLevel(uint8_t value)
 {
   m_level = q15_t(value * 128);
+
+  createModTable();
+}
+
+void CMode2TX::setMaxFEC(bool on)
+{
+  m_frame.setMaxFEC(on);
 }
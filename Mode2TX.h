@@ -21,6 +21,7 @@
 #if !defined(MODE2TX_H)
 #define  MODE2TX_H
 
+#include "Mode2Defines.h"
 #include "IL2PTX.h"
 #include "RingBuffer.h"
 #include "TokenStore.h"
@@ -34,23 +35,34 @@ public:
 
   void process();
 
+  void flushTokens();
+
   void setTXDelay(uint8_t value);
   void setTXTail(uint8_t value);
   void setLevel(uint8_t value);
+  void setMaxFEC(bool on);
 
 private:
-  CRingBuffer<uint8_t>             m_fifo;
-  uint16_t                         m_playOut;
-  arm_fir_interpolate_instance_q15 m_modFilter;
-  q15_t                            m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
-  CIL2PTX                          m_frame;
-  q15_t                            m_level;
-  uint16_t                         m_txDelay;
-  uint16_t                         m_txTail;
-  CTokenStore                      m_tokens;
+  CRingBuffer<uint8_t> m_fifo;
+  uint16_t             m_playOut;
+  q15_t                m_modTable[125U * MODE2_RADIO_SYMBOL_LENGTH];    // Five symbol values over a three symbol window
+  uint8_t              m_modWindow;
+  uint8_t              m_modPhase;
+  CIL2PTX              m_frame;
+  q15_t                m_level;
+  uint16_t             m_txDelay;
+  uint16_t             m_txTail;
+  uint16_t             m_burstWindow;
+  uint16_t             m_hold;
+  CTokenStore          m_tokens;
+  uint32_t             m_fifoOut;
 
   void writeByte(uint8_t c);
   void writeSilence();
+  uint8_t writeSymbol(uint8_t value, q15_t* out);
+  uint8_t getRate() const;
+  uint16_t getSpacerLength() const;
+  void createModTable();
 };
 
 #endif
@@ -0,0 +1,31 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(MODE3DEFINES_H)
+#define  MODE3DEFINES_H
+
+#include <cstdint>
+
+const uint8_t MODE3_RADIO_SYMBOL_LENGTH = 5U;      // At 48 kHz sample rate, 2.5 samples at 24 kHz
+
+// The G3RUH x^17 + x^12 + 1 scrambler taps, as delays in bits
+const uint8_t MODE3_SCRAMBLER_TAP1 = 12U;
+const uint8_t MODE3_SCRAMBLER_TAP2 = 17U;
+
+#endif
+
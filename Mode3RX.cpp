@@ -0,0 +1,145 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "KISSDefines.h"
+#include "Globals.h"
+#include "Mode3RX.h"
+#include "Utils.h"
+
+// LPF at 48 kHz, cutoff = 6000, doubled for the zero stuffing and padded to an even length
+static q15_t RX_FILTER[] = {  \
+      -4, -13, 0, 56, 130, \
+      138, 0, -265, -495, -452, \
+      0, 716, 1255, 1094, 0, \
+      -1661, -2924, -2618, 0, 4712, \
+      10234, 14678, 16379, 14678, 10234, \
+      4712, 0, -2618, -2924, -1661, \
+      0, 1094, 1255, 716, 0, \
+      -452, -495, -265, 0, 138, \
+      130, 56, 0, -13, -4, \
+      0 };
+const uint16_t RX_FILTER_PHASE_LEN = 23U; // phaseLength = numTaps/L
+
+const uint8_t DC_TRACK_SHIFT = 10U;      // DC tracking time constant of 1024 samples, about 21ms
+
+// One bit is a full turn of the phase, which wraps from positive to negative in the middle of the bit
+const int32_t PLL_STEP = int32_t(0x100000000ULL / MODE3_RADIO_SYMBOL_LENGTH);
+
+// Transitions within a quarter of a bit of where they are expected count towards the DCD
+const int32_t PLL_GOOD_PHASE = 0x20000000;
+
+const uint8_t DCD_ON_COUNT  = 28U;       // Out of the last 32 transitions
+const uint8_t DCD_OFF_COUNT = 20U;
+
+CMode3RX::CMode3RX() :
+m_filter(),
+m_state(),
+m_dcState(0),
+m_dcLevel(0),
+m_pllLast(false),
+m_pllPhase(0),
+m_dcdHistory(0U),
+m_dcd(false),
+m_scrambler(0U),
+m_nrziState(false),
+m_hdlc()
+{
+  ::memset(m_state, 0x00U, 30U * sizeof(q15_t));
+  m_filter.L           = 2U;
+  m_filter.phaseLength = RX_FILTER_PHASE_LEN;
+  m_filter.pCoeffs     = RX_FILTER;
+  m_filter.pState      = m_state;
+}
+
+void CMode3RX::samples(q15_t* samples, uint8_t length)
+{
+  // Upsampled to 48 kHz to give a whole number of samples per bit
+  q15_t vals[RX_BLOCK_SIZE * 2U];
+  ::arm_fir_interpolate_q15(&m_filter, samples, vals, RX_BLOCK_SIZE);
+
+  CAX25Frame frame;
+
+  for (uint8_t i = 0U; i < (length * 2U); i++) {
+    // The scrambled data is balanced, so any frequency offset can be tracked continuously
+    m_dcState += q31_t(vals[i]) - q31_t(m_dcLevel);
+    m_dcLevel  = q15_t(m_dcState >> DC_TRACK_SHIFT);
+
+    bool level = vals[i] >= m_dcLevel;
+
+    bool sample = PLL(level);
+    if (sample) {
+      // NRZI makes the decoding independent of the sense of the deviation
+      bool ok = m_hdlc.process(NRZI(descramble(level)), frame);
+      if (ok) {
+        stats.increment(STATS_MODE3_FRAMES);
+        LOG_MODE3_INFO("Mode3RX: frame CRC is valid", frame.m_length);
+        serial.writeKISSRXData(frame.m_data, frame.m_length - 2U, frame.m_start);
+      }
+    }
+  }
+
+  io.setDecode(m_dcd);
+}
+
+bool CMode3RX::PLL(bool level)
+{
+  int32_t prev = m_pllPhase;
+  m_pllPhase = int32_t(uint32_t(m_pllPhase) + uint32_t(PLL_STEP));
+
+  bool sample = (prev >= 0) && (m_pllPhase < 0);
+
+  if (level != m_pllLast) {
+    m_pllLast = level;
+
+    m_dcdHistory <<= 1;
+    if ((m_pllPhase > -PLL_GOOD_PHASE) && (m_pllPhase < PLL_GOOD_PHASE))
+      m_dcdHistory |= 0x01U;
+
+    uint8_t count = countBits32(m_dcdHistory);
+    if (count >= DCD_ON_COUNT)
+      m_dcd = true;
+    else if (count <= DCD_OFF_COUNT)
+      m_dcd = false;
+
+    // Pull the phase towards the transition, more gently once locked
+    m_pllPhase -= m_dcd ? (m_pllPhase / 8) : (m_pllPhase / 4);
+  }
+
+  return sample;
+}
+
+bool CMode3RX::descramble(bool b)
+{
+  bool out = b ^ (((m_scrambler >> (MODE3_SCRAMBLER_TAP1 - 1U)) & 0x01U) == 0x01U) ^ (((m_scrambler >> (MODE3_SCRAMBLER_TAP2 - 1U)) & 0x01U) == 0x01U);
+
+  m_scrambler = (m_scrambler << 1) | (b ? 0x01U : 0x00U);
+
+  return out;
+}
+
+bool CMode3RX::NRZI(bool b)
+{
+  bool result = (b == m_nrziState);
+
+  m_nrziState = b;
+
+  return result;
+}
+
@@ -0,0 +1,52 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(MODE3RX_H)
+#define  MODE3RX_H
+
+#include "Mode3Defines.h"
+#include "AX25HDLC.h"
+
+class CMode3RX {
+public:
+  CMode3RX();
+
+  void samples(q15_t* samples, uint8_t length);
+
+private:
+  arm_fir_interpolate_instance_q15 m_filter;
+  q15_t                m_state[30U];              // PhaseLength + BlockSize - 1, 23 + 2 - 1 plus some spare
+  q31_t                m_dcState;
+  q15_t                m_dcLevel;
+  bool                 m_pllLast;
+  int32_t              m_pllPhase;
+  uint32_t             m_dcdHistory;
+  bool                 m_dcd;
+  uint32_t             m_scrambler;
+  bool                 m_nrziState;
+  CAX25HDLC            m_hdlc;
+
+  bool PLL(bool level);
+  bool descramble(bool b);
+  bool NRZI(bool b);
+};
+
+#endif
+
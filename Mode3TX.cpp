@@ -0,0 +1,290 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#include "Globals.h"
+#include "Mode3TX.h"
+
+#include "AX25Defines.h"
+#include "AX25Frame.h"
+
+// Gaussian BT 0.6 convolved with 5 sample unit step function.
+static q15_t TX_PULSE_FILTER[] = {  \
+      0, 0, 0, 0, 0, \
+      0, 0, 0, 0, 0, \
+      0, 0, 0, 0, 0, \
+      0, 17, 319, 2659, 10668, \
+      22736, 30728, 32767, 30728, 22736, \
+      10668, 2659, 319, 17, 0, \
+      0, 0, 0, 0, 0, \
+      0, 0, 0, 0, 0, \
+      0, 0, 0, 0, 0 };
+
+// Only three polyphase branches of the pulse filter have non-zero taps, starting with this one
+const uint8_t MOD_FIRST_BRANCH = 3U;
+const uint8_t MOD_WINDOW_LEN   = 3U;
+const uint8_t MOD_WINDOWS      = 8U;
+
+// The same deviation as the outer mode 2 symbols
+const q15_t LEVEL = 1362;
+
+const uint8_t BIT_MASK_TABLE2[] = { 0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U };
+
+#define READ_BIT2(p,i)    (p[(i)>>3] & BIT_MASK_TABLE2[(i)&7])
+
+CMode3TX::CMode3TX() :
+m_fifo(2000U),
+m_playOut(0U),
+m_modTable(),
+m_modWindow(0U),
+m_modPhase(0U),
+m_bits(0U),
+m_bitCount(0U),
+m_nrzi(false),
+m_scrambler(0U),
+m_level(MODE3_TX_LEVEL * 128),
+m_txDelay((TX_DELAY / 10U) * 12U),
+m_txTail((TX_TAIL / 10U) * 12U),
+m_tokens(),
+m_fifoOut(0U)
+{
+  createModTable();
+}
+
+void CMode3TX::process()
+{
+  // Send back the tokens of the packets that have been transmitted
+  m_tokens.process();
+
+  // Transmit is off but we have data to send
+  if (!m_tx && m_fifo.getData() > 0U) {
+    bool tx = io.canTX();
+    if (!tx)
+      return;
+  }
+
+  // The trailer is flags, so a packet arriving during it can follow straight on
+  if (m_fifo.getData() > 0U)
+    m_playOut = 0U;
+
+  // Are we sending the trailer?
+  if (m_playOut > 0U) {
+    uint16_t space = io.getSpace();
+    while (space > (8U * MODE3_RADIO_SYMBOL_LENGTH)) {
+      writeByte(AX25_FRAME_END);
+
+      space -= 8U * MODE3_RADIO_SYMBOL_LENGTH;
+      m_playOut--;
+
+      if (m_playOut == 0U)
+        break;
+    }
+
+    return;
+  }
+
+  if (m_fifo.getData() > 0U) {
+    uint16_t space = io.getSpace();
+    while (space > (8U * MODE3_RADIO_SYMBOL_LENGTH)) {
+      m_tokens.update(m_fifoOut);
+
+      uint8_t c = 0U;
+      m_fifo.get(c);
+      m_fifoOut++;
+
+      writeByte(c);
+
+      space -= 8U * MODE3_RADIO_SYMBOL_LENGTH;
+
+      if (m_fifo.getData() == 0U) {
+        m_tokens.update(m_fifoOut);
+
+        m_playOut = m_txTail;
+        return;
+      }
+    }
+  }
+}
+
+void CMode3TX::flushTokens()
+{
+  m_tokens.flush();
+}
+
+uint8_t CMode3TX::writeData(const uint8_t* data, uint16_t length)
+{
+  CAX25Frame frame(data, length);
+  frame.addCRC();
+
+  // The flags, the frame with a fifth more for the worst case bit stuffing, and the padding
+  uint16_t needed = 1U + frame.m_length + (frame.m_length / 5U) + 1U + 2U;
+
+  uint16_t space = m_fifo.getSpace();
+  if (space < needed) {
+    LOG_MODE3_ERROR("Mode3TX: no space for the packet");
+    return 5U;
+  }
+
+  // Add the preamble flags, as many as will fit alongside the packet
+  if (!m_tx && (m_fifo.getData() == 0U)) {
+    uint16_t preamble = m_txDelay;
+    if (preamble > (space - needed))
+      preamble = space - needed;
+
+    for (uint16_t i = 0U; i < preamble; i++)
+      encodeFlag();
+  }
+
+  encodeFlag();
+
+  uint8_t ones = 0U;
+  for (uint16_t i = 0U; i < (frame.m_length * 8U); i++) {
+    bool b = READ_BIT2(frame.m_data, i) != 0U;
+    encodeBit(b);
+
+    if (b) {
+      ones++;
+      if (ones == AX25_MAX_ONES) {
+        // Bit stuffing
+        encodeBit(false);
+        ones = 0U;
+      }
+    } else {
+      ones = 0U;
+    }
+  }
+
+  encodeFlag();
+
+  // Pad the last byte out with the start of another flag
+  for (uint8_t i = 0U; m_bitCount > 0U; i++)
+    encodeBit(((AX25_FRAME_END << i) & 0x80U) == 0x80U);
+
+  return 0U;
+}
+
+uint8_t CMode3TX::writeDataAck(uint16_t token, const uint8_t* data, uint16_t length)
+{
+  if (!m_tokens.hasSpace()) {
+    LOG_MODE3_ERROR("Mode3TX: no space for the token");
+    return 5U;
+  }
+
+  // The packet runs from the end of the queue to the new end, its preamble counting as part of it
+  uint32_t start = m_fifoOut + m_fifo.getData();
+
+  uint8_t ret = writeData(data, length);
+  if (ret != 0U)
+    return ret;
+
+  m_tokens.add(token, start, m_fifoOut + m_fifo.getData());
+
+  return 0U;
+}
+
+void CMode3TX::encodeBit(bool b)
+{
+  m_bits = (m_bits << 1) | (b ? 0x01U : 0x00U);
+  m_bitCount++;
+
+  if (m_bitCount == 8U) {
+    m_fifo.put(m_bits);
+    m_bits     = 0U;
+    m_bitCount = 0U;
+  }
+}
+
+void CMode3TX::encodeFlag()
+{
+  for (uint8_t i = 0U; i < 8U; i++)
+    encodeBit(((AX25_FRAME_START << i) & 0x80U) == 0x80U);
+}
+
+void CMode3TX::writeByte(uint8_t c)
+{
+  q15_t outBuffer[8U * MODE3_RADIO_SYMBOL_LENGTH];
+
+  uint8_t n = 0U;
+  for (uint8_t i = 0U; i < 8U; i++, c <<= 1) {
+    // NRZI, a zero is sent as a change
+    if ((c & 0x80U) == 0x00U)
+      m_nrzi = !m_nrzi;
+
+    // G3RUH scrambler, x^17 + x^12 + 1
+    bool b = m_nrzi ^ (((m_scrambler >> (MODE3_SCRAMBLER_TAP1 - 1U)) & 0x01U) == 0x01U) ^ (((m_scrambler >> (MODE3_SCRAMBLER_TAP2 - 1U)) & 0x01U) == 0x01U);
+    m_scrambler = (m_scrambler << 1) | (b ? 0x01U : 0x00U);
+
+    n += writeBit(b, outBuffer + n);
+  }
+
+  io.write(outBuffer, n);
+}
+
+uint8_t CMode3TX::writeBit(bool b, q15_t* out)
+{
+  m_modWindow = ((m_modWindow << 1) | (b ? 0x01U : 0x00U)) & (MOD_WINDOWS - 1U);
+
+  const q15_t* in = m_modTable + m_modWindow * MODE3_RADIO_SYMBOL_LENGTH;
+
+  // Shaped at 48 kHz and every other sample is kept, so the bits alternate between three and two samples
+  uint8_t n = 0U;
+  for (uint8_t j = m_modPhase; j < MODE3_RADIO_SYMBOL_LENGTH; j += 2U)
+    out[n++] = in[j];
+
+  m_modPhase ^= 0x01U;
+
+  return n;
+}
+
+void CMode3TX::createModTable()
+{
+  // The output of the pulse filter for every window of bits, oldest first, at the current level
+  q31_t res = LEVEL * m_level;
+  q15_t level = q15_t(__SSAT((res >> 15), 16));
+
+  for (uint8_t window = 0U; window < MOD_WINDOWS; window++) {
+    for (uint8_t j = 0U; j < MODE3_RADIO_SYMBOL_LENGTH; j++) {
+      q63_t sum = 0;
+      for (uint8_t i = 0U; i < MOD_WINDOW_LEN; i++) {
+        bool b = ((window >> (MOD_WINDOW_LEN - 1U - i)) & 0x01U) == 0x01U;
+        sum += q31_t(b ? level : -level) * TX_PULSE_FILTER[(MOD_FIRST_BRANCH + i) * MODE3_RADIO_SYMBOL_LENGTH + MODE3_RADIO_SYMBOL_LENGTH - 1U - j];
+      }
+
+      m_modTable[window * MODE3_RADIO_SYMBOL_LENGTH + j] = q15_t(__SSAT((sum >> 15), 16));
+    }
+  }
+}
+
+void CMode3TX::setTXDelay(uint8_t value)
+{
+  m_txDelay = value * 12U;
+}
+
+void CMode3TX::setTXTail(uint8_t value)
+{
+  m_txTail = value * 12U;
+}
+
+void CMode3TX::setLevel(uint8_t value)
+{
+  m_level = q15_t(value * 128);
+
+  createModTable();
+}
+
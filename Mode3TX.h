@@ -0,0 +1,67 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(MODE3TX_H)
+#define  MODE3TX_H
+
+#include "Mode3Defines.h"
+#include "RingBuffer.h"
+#include "TokenStore.h"
+
+class CMode3TX {
+public:
+  CMode3TX();
+
+  uint8_t writeData(const uint8_t* data, uint16_t length);
+  uint8_t writeDataAck(uint16_t token, const uint8_t* data, uint16_t length);
+
+  void process();
+
+  void flushTokens();
+
+  void setTXDelay(uint8_t value);
+  void setTXTail(uint8_t value);
+  void setLevel(uint8_t value);
+
+private:
+  CRingBuffer<uint8_t> m_fifo;                                           // HDLC bits after stuffing, first bit in the MSB
+  uint16_t             m_playOut;
+  q15_t                m_modTable[8U * MODE3_RADIO_SYMBOL_LENGTH];       // Two bit values over a three bit window
+  uint8_t              m_modWindow;
+  uint8_t              m_modPhase;
+  uint8_t              m_bits;
+  uint8_t              m_bitCount;
+  bool                 m_nrzi;
+  uint32_t             m_scrambler;
+  q15_t                m_level;
+  uint16_t             m_txDelay;
+  uint16_t             m_txTail;
+  CTokenStore          m_tokens;
+  uint32_t             m_fifoOut;
+
+  void encodeBit(bool b);
+  void encodeFlag();
+  void writeByte(uint8_t c);
+  uint8_t writeBit(bool b, q15_t* out);
+  void createModTable();
+};
+
+#endif
+
@@ -49,8 +49,14 @@ public:
 
   bool put(TDATATYPE item) volatile;
 
+  bool put(const TDATATYPE* items, uint16_t length);
+
+  bool fill(TDATATYPE item, uint16_t count);
+
   bool get(TDATATYPE& item) volatile;
 
+  bool get(TDATATYPE* items, uint16_t length);
+
   TDATATYPE peek() const;
 
   bool hasOverflowed();
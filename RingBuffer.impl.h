@@ -19,6 +19,8 @@
 
 #include "RingBuffer.h"
 
+#include <cstring>
+
 template <typename TDATATYPE> CRingBuffer<TDATATYPE>::CRingBuffer(uint16_t length) :
 m_length(length),
 m_head(0U),
@@ -75,6 +77,58 @@ template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::put(TDATATYPE item) v
   return true;
 }
 
+template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::put(const TDATATYPE* items, uint16_t length)
+{
+  if (length > getSpace()) {
+    m_overflow = true;
+    return false;
+  }
+
+  if (length == 0U)
+    return true;
+
+  // Copy up to the end of the buffer and then any remainder from the start
+  uint16_t first = m_length - m_head;
+  if (first > length)
+    first = length;
+
+  ::memcpy(m_buffer + m_head, items, first * sizeof(TDATATYPE));
+  ::memcpy(m_buffer, items + first, (length - first) * sizeof(TDATATYPE));
+
+  m_head += length;
+  if (m_head >= m_length)
+    m_head -= m_length;
+
+  if (m_head == m_tail)
+    m_full = true;
+
+  return true;
+}
+
+template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::fill(TDATATYPE item, uint16_t count)
+{
+  if (count > getSpace()) {
+    m_overflow = true;
+    return false;
+  }
+
+  if (count == 0U)
+    return true;
+
+  for (uint16_t i = 0U; i < count; i++) {
+    m_buffer[m_head] = item;
+
+    m_head++;
+    if (m_head >= m_length)
+      m_head = 0U;
+  }
+
+  if (m_head == m_tail)
+    m_full = true;
+
+  return true;
+}
+
 template <typename TDATATYPE> TDATATYPE CRingBuffer<TDATATYPE>::peek() const
 {
   return m_buffer[m_tail];
@@ -96,6 +150,31 @@ template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::get(TDATATYPE& item)
   return true;
 }
 
+template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::get(TDATATYPE* items, uint16_t length)
+{
+  if (length > getData())
+    return false;
+
+  if (length == 0U)
+    return true;
+
+  // Copy up to the end of the buffer and then any remainder from the start
+  uint16_t first = m_length - m_tail;
+  if (first > length)
+    first = length;
+
+  ::memcpy(items, m_buffer + m_tail, first * sizeof(TDATATYPE));
+  ::memcpy(items + first, m_buffer, (length - first) * sizeof(TDATATYPE));
+
+  m_tail += length;
+  if (m_tail >= m_length)
+    m_tail -= m_length;
+
+  m_full = false;
+
+  return true;
+}
+
 template <typename TDATATYPE> bool CRingBuffer<TDATATYPE>::hasOverflowed()
 {
   bool overflow = m_overflow;
@@ -21,8 +21,25 @@
 
 #include "STMUART.h"
 
+#include <cstring>
+
+#if defined(STM32F7XX)
+#define USART_RX_REGISTER(u)  ((uint32_t)&(u)->RDR)
+#define USART_TX_REGISTER(u)  ((uint32_t)&(u)->TDR)
+#else
+#define USART_RX_REGISTER(u)  ((uint32_t)&(u)->DR)
+#define USART_TX_REGISTER(u)  ((uint32_t)&(u)->DR)
+#endif
+
 CSTMUART::CSTMUART() :
-m_usart(NULL)
+m_usart(NULL),
+m_rxFifo(),
+m_txFifo(),
+m_rxStream(NULL),
+m_txStream(NULL),
+m_txFlags(0U),
+m_txLength(0U),
+m_rxDrops(0U)
 {
 
 }
@@ -32,20 +49,90 @@ void CSTMUART::init(USART_TypeDef* usart)
   m_usart = usart;
 }
 
+// Reception is by circular DMA straight into the RX FIFO, with the idle line interrupt marking the end of
+// each burst from the host, and transmission is by DMA from the TX FIFO one contiguous span at a time
+void CSTMUART::initDMA(USART_TypeDef* usart, DMA_Stream_TypeDef* rxStream, DMA_Stream_TypeDef* txStream, uint32_t channel, uint32_t txFlags)
+{
+  m_usart    = usart;
+  m_rxStream = rxStream;
+  m_txStream = txStream;
+  m_txFlags  = txFlags;
+
+  DMA_InitTypeDef DMA_InitStructure;
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_Channel            = channel;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = USART_RX_REGISTER(usart);
+  DMA_InitStructure.DMA_Memory0BaseAddr    = (uint32_t)m_rxFifo.getBuffer();
+  DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralToMemory;
+  DMA_InitStructure.DMA_BufferSize         = BUFFER_SIZE;
+  DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority           = DMA_Priority_Medium;
+  DMA_Init(rxStream, &DMA_InitStructure);
+
+  DMA_InitStructure.DMA_PeripheralBaseAddr = USART_TX_REGISTER(usart);
+  DMA_InitStructure.DMA_Memory0BaseAddr    = (uint32_t)m_txFifo.getBuffer();
+  DMA_InitStructure.DMA_DIR                = DMA_DIR_MemoryToPeripheral;
+  DMA_InitStructure.DMA_BufferSize         = 1U;
+  DMA_InitStructure.DMA_Mode               = DMA_Mode_Normal;
+  DMA_Init(txStream, &DMA_InitStructure);
+
+  DMA_Cmd(rxStream, ENABLE);
+
+  USART_DMACmd(usart, USART_DMAReq_Rx | USART_DMAReq_Tx, ENABLE);
+
+  USART_ITConfig(usart, USART_IT_IDLE, ENABLE);
+}
+
 void CSTMUART::write(const uint8_t * data, uint16_t length)
 {
   if(length == 0U || m_usart == NULL)
     return;
 
+  if (m_txStream != NULL) {
+    for(uint16_t i = 0U; i < length; i++)
+      m_txFifo.put(data[i]);
 
-  m_txFifo.put(data[0]);
-  USART_ITConfig(m_usart, USART_IT_TXE, ENABLE);//switch TX IRQ is on
+    // If a transfer is running, its completion interrupt starts the next one
+    if (m_txLength == 0U)
+      startTX();
+
+    return;
+  }
 
-  for(uint16_t i = 1U; i < length; i++) {
+  for(uint16_t i = 0U; i < length; i++) {
     m_txFifo.put(data[i]);
   }
 
-  USART_ITConfig(m_usart, USART_IT_TXE, ENABLE);//make sure TX IRQ is on
+  USART_ITConfig(m_usart, USART_IT_TXE, ENABLE);//switch TX IRQ on once the whole block is queued
+}
+
+void CSTMUART::startTX()
+{
+  uint16_t length = m_txFifo.getSpan();
+  if (length == 0U) {
+    m_txLength = 0U;
+    USART_ITConfig(m_usart, USART_IT_TC, DISABLE);
+    return;
+  }
+
+  m_txLength = length;
+
+  DMA_Cmd(m_txStream, DISABLE);
+  while (DMA_GetCmdStatus(m_txStream) == ENABLE)
+    ;
+
+  DMA_ClearFlag(m_txStream, m_txFlags);
+  DMA_MemoryTargetConfig(m_txStream, (uint32_t)m_txFifo.getTail(), DMA_Memory_0);
+  DMA_SetCurrDataCounter(m_txStream, length);
+
+  USART_ClearFlag(m_usart, USART_FLAG_TC);
+  DMA_Cmd(m_txStream, ENABLE);
+
+  USART_ITConfig(m_usart, USART_IT_TC, ENABLE);
 }
 
 uint8_t CSTMUART::read()
@@ -53,14 +140,66 @@ uint8_t CSTMUART::read()
   return m_rxFifo.get();
 }
 
+// Copy out as much as is waiting, up to the length, a contiguous span at a time
+uint16_t CSTMUART::read(uint8_t* data, uint16_t length)
+{
+  uint16_t n = 0U;
+
+  while (n < length) {
+    uint16_t span = m_rxFifo.getSpan();
+    if (span == 0U)
+      break;
+
+    if (span > (length - n))
+      span = length - n;
+
+    ::memcpy(data + n, (const uint8_t*)m_rxFifo.getTail(), span);
+
+    // The idle line interrupt also moves the tail, when reception overruns the FIFO
+    if (m_rxStream != NULL)
+      USART_ITConfig(m_usart, USART_IT_IDLE, DISABLE);
+    m_rxFifo.advance(span);
+    if (m_rxStream != NULL)
+      USART_ITConfig(m_usart, USART_IT_IDLE, ENABLE);
+
+    n += span;
+  }
+
+  return n;
+}
+
 void CSTMUART::handleIRQ()
 {
   if(m_usart == NULL)
     return;
 
+  if (m_rxStream != NULL) {
+    if (USART_GetITStatus(m_usart, USART_IT_IDLE)) {
+      // Clearing the idle flag needs a read of the status register followed by the data register on the F4
+#if defined(STM32F7XX)
+      USART_ClearITPendingBit(m_usart, USART_IT_IDLE);
+#else
+      USART_ReceiveData(m_usart);
+#endif
+      m_rxDrops += m_rxFifo.setHead(BUFFER_SIZE - DMA_GetCurrDataCounter(m_rxStream));
+    }
+
+    if (USART_GetITStatus(m_usart, USART_IT_TC)) {
+      USART_ClearITPendingBit(m_usart, USART_IT_TC);
+
+      m_txFifo.advance(m_txLength);
+      startTX();
+    }
+
+    return;
+  }
+
   if (USART_GetITStatus(m_usart, USART_IT_RXNE)) {
-    if(!m_rxFifo.isFull())
-      m_rxFifo.put((uint8_t) USART_ReceiveData(m_usart));
+    uint8_t c = (uint8_t) USART_ReceiveData(m_usart);
+    if (!m_rxFifo.isFull())
+      m_rxFifo.put(c);
+    else
+      m_rxDrops++;
     USART_ClearITPendingBit(USART1, USART_IT_RXNE);
   }
 
@@ -82,19 +221,79 @@ void CSTMUART::flush()
   if(m_usart == NULL)
     return;
 
-   // wait until the TXE shows the shift register is empty
-   while (USART_GetITStatus(m_usart, USART_FLAG_TXE))
+   // wait for the FIFO to be emptied, by DMA or interrupt
+   while (m_txLength > 0U || !m_txFifo.isEmpty())
+      ;
+
+   // wait until the TC shows the shift register is empty
+   while (USART_GetFlagStatus(m_usart, USART_FLAG_TC) == RESET)
       ;
 }
 
 uint16_t CSTMUART::available()
 {
+  if (m_rxStream != NULL) {
+    // Collect anything received since the last idle line, with the interrupt masked as it also moves the head
+    USART_ITConfig(m_usart, USART_IT_IDLE, DISABLE);
+    m_rxDrops += m_rxFifo.setHead(BUFFER_SIZE - DMA_GetCurrDataCounter(m_rxStream));
+    USART_ITConfig(m_usart, USART_IT_IDLE, ENABLE);
+
+    return m_rxFifo.getData();
+  }
+
   return m_rxFifo.isEmpty() ? 0U : 1U;
 }
 
 uint16_t CSTMUART::availableForWrite()
 {
-  return m_txFifo.isFull() ? 0U : 1U;
+  return m_txFifo.getSpace();
+}
+
+// The total of received bytes lost because the RX FIFO was full, it is never reset
+uint32_t CSTMUART::getRXDrops() const
+{
+  return m_rxDrops;
+}
+
+uint32_t CSTMUART::getClock() const
+{
+  RCC_ClocksTypeDef clocks;
+  RCC_GetClocksFreq(&clocks);
+
+  // USART1 is on APB2, the others on APB1
+  return (m_usart == USART1) ? clocks.PCLK2_Frequency : clocks.PCLK1_Frequency;
+}
+
+// With 16x oversampling the baud rate register is the peripheral clock divided by the baud rate, and the
+// resulting rate must be within 2% of that wanted
+bool CSTMUART::checkSpeed(uint32_t speed) const
+{
+  if (m_usart == NULL || speed == 0U)
+    return false;
+
+  uint32_t clock = getClock();
+
+  uint32_t brr = (clock + speed / 2U) / speed;
+  if (brr < 16U || brr > 0xFFFFU)
+    return false;
+
+  uint32_t actual = clock / brr;
+  uint32_t error  = (actual > speed) ? (actual - speed) : (speed - actual);
+
+  return (error * 50U) <= speed;
+}
+
+// Any transmission should have been flushed first
+void CSTMUART::setSpeed(uint32_t speed)
+{
+  if (m_usart == NULL || speed == 0U)
+    return;
+
+  uint32_t clock = getClock();
+
+  USART_Cmd(m_usart, DISABLE);
+  m_usart->BRR = (clock + speed / 2U) / speed;
+  USART_Cmd(m_usart, ENABLE);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -27,64 +27,36 @@
 #include "stm32f7xx.h"
 #endif
 
-const uint16_t BUFFER_SIZE = 2048U; //needs to be a power of 2 !
-const uint16_t BUFFER_MASK = BUFFER_SIZE - 1;
-
-class CSTMUARTFIFO {
-public:
-  CSTMUARTFIFO() :
-  m_head(0U),
-  m_tail(0U)
-  {
-  }
-
-  void put(uint8_t data)
-  {
-    m_buffer[BUFFER_MASK & (m_head++)] = data;
-  }
-
-  uint8_t get()
-  {
-    return m_buffer[BUFFER_MASK & (m_tail++)];
-  }
-
-  void reset()
-  {
-    m_tail = 0U;
-    m_head = 0U;
-  }
-
-  bool isEmpty()
-  {
-    return m_tail == m_head;
-  }
-
-  bool isFull()
-  {
-    return ((m_head + 1U) & BUFFER_MASK) == (m_tail & BUFFER_MASK);
-  }
-
-private:
-  volatile uint8_t  m_buffer[BUFFER_SIZE];
-  volatile uint16_t m_head;
-  volatile uint16_t m_tail;
-};
+#include "STMUARTFIFO.h"
 
 class CSTMUART {
 public:
   CSTMUART();
   void init(USART_TypeDef* usart);
+  void initDMA(USART_TypeDef* usart, DMA_Stream_TypeDef* rxStream, DMA_Stream_TypeDef* txStream, uint32_t channel, uint32_t txFlags);
   void write(const uint8_t * data, uint16_t length);
   uint8_t read();
+  uint16_t read(uint8_t* data, uint16_t length);
   void handleIRQ();
   void flush();
   uint16_t available();
   uint16_t availableForWrite();
+  bool checkSpeed(uint32_t speed) const;
+  uint32_t getRXDrops() const;
+  void setSpeed(uint32_t speed);
 
 private:
-  USART_TypeDef * m_usart;
-  CSTMUARTFIFO    m_rxFifo;
-  CSTMUARTFIFO    m_txFifo;
+  USART_TypeDef *      m_usart;
+  CSTMUARTFIFO         m_rxFifo;
+  CSTMUARTFIFO         m_txFifo;
+  DMA_Stream_TypeDef * m_rxStream;
+  DMA_Stream_TypeDef * m_txStream;
+  uint32_t             m_txFlags;
+  volatile uint16_t    m_txLength;
+  volatile uint32_t    m_rxDrops;
+
+  void startTX();
+  uint32_t getClock() const;
 };
 
 #endif
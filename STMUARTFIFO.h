@@ -0,0 +1,125 @@
+/*
+ *   Copyright (c) 2020,2024 by Jonathan Naylor G4KLX
+ *   Copyright (c) 2020 by Geoffrey Merck F4FXL - KC3FRA
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(STMUARTFIFO_H)
+#define STMUARTFIFO_H
+
+// This has no processor dependencies so that it can be built and tested on a host
+
+#include <cstdint>
+
+const uint16_t BUFFER_SIZE = 2048U; //needs to be a power of 2 !
+const uint16_t BUFFER_MASK = BUFFER_SIZE - 1;
+
+// The head and tail are free running and only masked when used as an index, so
+// the difference between them is always the amount of data waiting
+class CSTMUARTFIFO {
+public:
+  CSTMUARTFIFO() :
+  m_head(0U),
+  m_tail(0U)
+  {
+  }
+
+  void put(uint8_t data)
+  {
+    m_buffer[BUFFER_MASK & (m_head++)] = data;
+  }
+
+  uint8_t get()
+  {
+    return m_buffer[BUFFER_MASK & (m_tail++)];
+  }
+
+  void reset()
+  {
+    m_tail = 0U;
+    m_head = 0U;
+  }
+
+  bool isEmpty()
+  {
+    return m_tail == m_head;
+  }
+
+  bool isFull()
+  {
+    return ((m_head + 1U) & BUFFER_MASK) == (m_tail & BUFFER_MASK);
+  }
+
+  uint16_t getData() const
+  {
+    return uint16_t(m_head - m_tail);
+  }
+
+  uint16_t getSpace() const
+  {
+    return BUFFER_MASK - getData();
+  }
+
+  // The number of bytes that can be read from the tail without wrapping, used for DMA transmission
+  uint16_t getSpan() const
+  {
+    uint16_t data  = getData();
+    uint16_t toEnd = BUFFER_SIZE - (m_tail & BUFFER_MASK);
+
+    return (data < toEnd) ? data : toEnd;
+  }
+
+  const volatile uint8_t* getTail() const
+  {
+    return m_buffer + (m_tail & BUFFER_MASK);
+  }
+
+  // Remove bytes that have been read directly from the buffer
+  void advance(uint16_t length)
+  {
+    m_tail += length;
+  }
+
+  // Move the head up to the offset in the buffer that circular DMA reception has reached. If reception has
+  // overtaken the tail, the oldest bytes have been overwritten, so they are dropped and their number returned
+  uint16_t setHead(uint16_t offset)
+  {
+    uint16_t length = uint16_t(offset - m_head) & BUFFER_MASK;
+    uint16_t space  = getSpace();
+
+    m_head += length;
+
+    if (length <= space)
+      return 0U;
+
+    uint16_t lost = length - space;
+    m_tail += lost;
+
+    return lost;
+  }
+
+  volatile uint8_t* getBuffer()
+  {
+    return m_buffer;
+  }
+
+private:
+  volatile uint8_t  m_buffer[BUFFER_SIZE];
+  volatile uint16_t m_head;
+  volatile uint16_t m_tail;
+};
+
+#endif
@@ -60,13 +60,66 @@ const char HARDWARE[] = concat(HW_TYPE, VERSION, TCXO, GITVERSION);
 const char HARDWARE[] = concat(HW_TYPE, VERSION, TCXO, __TIME__, __DATE__);
 #endif
 
+const uint16_t KISS_STAGING_LENGTH = 128U;
+
+const uint16_t SERIAL_READ_LENGTH = 128U;
+
+const uint16_t RX_QUEUE_LENGTH = 4000U;
+const uint16_t RX_QUEUE_FRAMES = 40U;
+
+// Set on a queued length when the frame after it belongs to it, the two are sent and dropped together
+const uint16_t RX_QUEUE_JOINED = 0x8000U;
+
+const uint32_t SERIAL_SPEEDS[] = { 115200U, 230400U, 460800U, 921600U };
+const uint8_t  SERIAL_SPEEDS_COUNT = 4U;
+
+const uint32_t SPEED_CONFIRM_TIME = 2U * 24000U;    // Two seconds of samples
+
+#if defined(SERIAL_DEBUGGING)
+const uint16_t DEBUG_QUEUE_LENGTH = 1000U;
+#else
+const uint16_t DEBUG_QUEUE_LENGTH = 1U;
+#endif
+const uint16_t DEBUG_WRITE_LENGTH = 64U;
+
+#if !defined(LOG_LEVEL_STARTUP)
+#define LOG_LEVEL_STARTUP LOGL_INFO
+#endif
+
+// The highest level built in for each subsystem, in the order of LOG_SUBSYSTEM
+const uint8_t LOG_LEVELS_BUILT[] = { LOG_LEVEL_GENERAL, LOG_LEVEL_MODE1, LOG_LEVEL_IL2P, LOG_LEVEL_MODE2, LOG_LEVEL_MODE3 };
+
+const uint8_t  DEBUG_EVENT_SYNC = 0xA5U;
+const uint8_t  DEBUG_EVENT_MAX_LENGTH = 1U + 1U + 4U + 5U * 2U + 1U;
 
 CSerialPort::CSerialPort() :
 m_buffer(),
 m_ptr(0U),
 m_inFrame(false),
-m_isEscaped(false)
+m_isEscaped(false),
+m_overflow(false),
+m_rxQueue(RX_QUEUE_LENGTH),
+m_rxLengths(RX_QUEUE_FRAMES),
+m_current(),
+m_currentLen(0U),
+m_currentPtr(0U),
+m_currentOffset(0U),
+m_currentNext(0U),
+m_speedState(SPEEDS_NONE),
+m_speed(SERIAL_SPEED),
+m_newSpeed(SERIAL_SPEED),
+m_speedTimer(0U),
+m_speedFrames(0U),
+m_uartDrops(0U),
+m_timestamps(false),
+m_freqOffsets(false),
+m_ackTimes(false),
+m_debugQueue(DEBUG_QUEUE_LENGTH),
+m_debugLost(0U),
+m_logLevels()
 {
+  for (uint8_t i = 0U; i < LOGS_COUNT; i++)
+    m_logLevels[i] = (LOG_LEVEL_STARTUP < LOG_LEVELS_BUILT[i]) ? LOG_LEVEL_STARTUP : LOG_LEVELS_BUILT[i];
 }
 
 void CSerialPort::start()
@@ -76,48 +129,136 @@ void CSerialPort::start()
   beginInt(3U, DEBUGGING_SPEED);
 #endif
 
-  DEBUG1(HARDWARE);
+  LOG_GENERAL_INFO(HARDWARE);
 
   io.showMode();
 }
 
 void CSerialPort::process()
 {
+  // The UART keeps a running total of the received bytes it has lost
+  uint32_t drops = getRXDropsInt(1U);
+  if (drops != m_uartDrops) {
+    stats.increment(STATS_UART_RX_DROPS, drops - m_uartDrops);
+    LOG_GENERAL_ERROR("SerialPort: bytes from the host lost, total lost", stats.get(STATS_UART_RX_DROPS));
+    m_uartDrops = drops;
+  }
+
+  writeQueue();
+
+  processSpeed();
+
+#if defined(SERIAL_DEBUGGING)
+  writeDebugQueue();
+#endif
+
   while (availableForReadInt(1U)) {
-    uint8_t c = readInt(1U);
+    uint8_t buffer[SERIAL_READ_LENGTH];
+    uint16_t length = readInt(1U, buffer, SERIAL_READ_LENGTH);
+    if (length == 0U)
+      break;
+
+    processKISS(buffer, length);
+  }
+}
+
+// Returns the offset of the first FEND or FESC, or the length if there is neither. Four bytes are checked at a
+// time, a byte of the word XORed with a wanted value being zero if it matched.
+static uint16_t findSpecial(const uint8_t* data, uint16_t length)
+{
+  uint16_t i = 0U;
+
+  for (; (i + 4U) <= length; i += 4U) {
+    uint32_t word;
+    ::memcpy(&word, data + i, 4U);
 
+    uint32_t fend = word ^ 0xC0C0C0C0U;
+    uint32_t fesc = word ^ 0xDBDBDBDBU;
+
+    uint32_t zero = ((fend - 0x01010101U) & ~fend) | ((fesc - 0x01010101U) & ~fesc);
+    if ((zero & 0x80808080U) != 0U)
+      break;
+  }
+
+  for (; i < length; i++) {
+    if ((data[i] == KISS_FEND) || (data[i] == KISS_FESC))
+      return i;
+  }
+
+  return length;
+}
+
+void CSerialPort::processKISS(const uint8_t* data, uint16_t length)
+{
+  while (length > 0U) {
     if (!m_inFrame) {
-      if (c == KISS_FEND) {
-        // Handle the frame start
-        m_inFrame   = true;
-        m_isEscaped = false;
-        m_ptr       = 0U;
+      // Skip to the frame start
+      const uint8_t* p = (const uint8_t*)::memchr(data, KISS_FEND, length);
+      if (p == NULL)
+        return;
+
+      length -= (p - data) + 1U;
+      data    = p + 1U;
+
+      m_inFrame   = true;
+      m_isEscaped = false;
+      m_overflow  = false;
+      m_ptr       = 0U;
+      continue;
+    }
+
+    uint8_t c = data[0U];
+
+    if (m_isEscaped) {
+      m_isEscaped = false;
+
+      if (c == KISS_TFESC)
+        c = KISS_FESC;
+      else if (c == KISS_TFEND)
+        c = KISS_FEND;
+      else if (c == KISS_FEND)
+        continue;             // Handled as an ordinary frame end below
+
+      if (m_ptr < sizeof(m_buffer))
+        m_buffer[m_ptr++] = c;
+      else
+        m_overflow = true;
+
+      data++;
+      length--;
+      continue;
+    }
+
+    // Copy everything up to the next FEND or FESC in one go
+    uint16_t run = findSpecial(data, length);
+    if (run > 0U) {
+      if ((m_ptr + run) <= sizeof(m_buffer)) {
+        ::memcpy(m_buffer + m_ptr, data, run);
+        m_ptr += run;
+      } else {
+        m_overflow = true;
       }
+
+      data   += run;
+      length -= run;
+      continue;
+    }
+
+    data++;
+    length--;
+
+    if (c == KISS_FESC) {
+      m_isEscaped = true;
     } else {
-      // Any other bytes are added to the buffer-ish
-      switch (c) {
-        case KISS_TFESC:
-          m_buffer[m_ptr++] = m_isEscaped ? KISS_FESC : KISS_TFESC;
-          m_isEscaped = false;
-          break;
-        case KISS_TFEND:
-          m_buffer[m_ptr++] = m_isEscaped ? KISS_FEND : KISS_TFEND;
-          m_isEscaped = false;
-          break;
-        case KISS_FESC:
-          m_isEscaped = true;
-          break;
-        case KISS_FEND:
-          if (m_ptr > 0U)
-            processMessage();
-          m_inFrame   = false;
-          m_isEscaped = false;
-          m_ptr       = 0U;
-          break;
-        default:
-          m_buffer[m_ptr++] = c;
-          break;
-      }
+      if (m_overflow)
+        LOG_GENERAL_ERROR("SerialPort: KISS frame too long, discarded");
+      else if (m_ptr > 0U)
+        processMessage();
+
+      m_inFrame   = false;
+      m_isEscaped = false;
+      m_overflow  = false;
+      m_ptr       = 0U;
     }
   }
 }
@@ -128,247 +269,617 @@ void CSerialPort::processMessage()
   if ((m_buffer[0U] & 0xF0U) != (KISS_ADDRESS << 4))
     return;
 
+  // Until a new speed is confirmed anything else received may be garbage
+  if ((m_speedState == SPEEDS_CONFIRM) && ((m_buffer[0U] & 0x0FU) != KISS_TYPE_SET_SPEED))
+    return;
+
   switch (m_buffer[0U] & 0x0FU) {
     case KISS_TYPE_DATA:
       switch (m_mode) {
         case 1U:
+        case 5U:
           ax25TX.writeData(m_buffer + 1U, m_ptr - 1U);
           break;
         case 2U:
+        case 4U:
           mode2TX.writeData(m_buffer + 1U, m_ptr - 1U);
           break;
+        case 3U:
+          mode3TX.writeData(m_buffer + 1U, m_ptr - 1U);
+          break;
       }
       break;
     case KISS_TYPE_TX_DELAY:
       if (m_ptr == 2U) {
         ax25TX.setTXDelay(m_buffer[1U]);
         mode2TX.setTXDelay(m_buffer[1U]);
-        DEBUG2("Setting TX Delay to", m_buffer[1U]);
+        mode3TX.setTXDelay(m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting TX Delay to", m_buffer[1U]);
       }
       break;
     case KISS_TYPE_P_PERSISTENCE:
       if (m_ptr == 2U) {
         io.setPPersist(m_buffer[1U]);
-        DEBUG2("Setting p-Persistence to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting p-Persistence to", m_buffer[1U]);
       }
       break;
     case KISS_TYPE_SLOT_TIME:
       if (m_ptr == 2U) {
         io.setSlotTime(m_buffer[1U]);
-        DEBUG2("Setting Slot Time to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting Slot Time to", m_buffer[1U]);
       }
       break;
     case KISS_TYPE_TX_TAIL:
       if (m_ptr == 2U) {
         mode2TX.setTXTail(m_buffer[1U]);
-        DEBUG2("Setting TX Tail to", m_buffer[1U]);
+        mode3TX.setTXTail(m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting TX Tail to", m_buffer[1U]);
       }
       break;
     case KISS_TYPE_FULL_DUPLEX:
       if (m_ptr == 2U) {
         m_duplex = (m_buffer[1U] != 0U);
-        DEBUG2("Setting Full Duplex to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting Full Duplex to", m_buffer[1U]);
+      }
+      break;
+    case KISS_TYPE_TIMESTAMPS:
+      if (m_ptr == 2U) {
+        m_timestamps = (m_buffer[1U] != 0U);
+        LOG_GENERAL_INFO("Setting Timestamps to", m_buffer[1U]);
+      }
+      break;
+    case KISS_TYPE_ACK_TIMES:
+      if (m_ptr == 2U) {
+        m_ackTimes = (m_buffer[1U] != 0U);
+        LOG_GENERAL_INFO("Setting ACK Times to", m_buffer[1U]);
+      }
+      break;
+    case KISS_TYPE_FREQ_OFFSET:
+      if (m_ptr == 2U) {
+        m_freqOffsets = (m_buffer[1U] != 0U);
+        LOG_GENERAL_INFO("Setting Frequency Offsets to", m_buffer[1U]);
       }
       break;
     case KISS_TYPE_SET_HARDWARE:
       if (m_ptr == 2U) {
         m_mode = m_buffer[1U];
+        flushTokens();
         io.showMode();
-        DEBUG2("Setting Mode to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting Mode to", m_buffer[1U]);
+      } else if (m_ptr == 3U) {
+        m_mode = m_buffer[1U];
+        flushTokens();
+        io.showMode();
+        LOG_GENERAL_INFO("Setting Mode to", m_buffer[1U]);
+        if (m_mode == 1U) {
+          ax25TX.setFX25(m_buffer[2U]);
+          LOG_GENERAL_INFO("Setting Mode 1 FX.25 check bytes to", m_buffer[2U]);
+        } else if (m_mode == 5U) {
+          ax25TX.setIL2PMaxFEC(m_buffer[2U] != 0U);
+          LOG_GENERAL_INFO("Setting Mode 5 Max FEC to", m_buffer[2U]);
+        } else if ((m_mode == 2U) || (m_mode == 4U)) {
+          mode2TX.setMaxFEC(m_buffer[2U] != 0U);
+          LOG_GENERAL_INFO("Setting Mode 2 Max FEC to", m_buffer[2U]);
+        }
       } else if (m_ptr == 4U) {
         io.setRXLevel(m_buffer[1U]);
         ax25TX.setLevel(m_buffer[2]);
         mode2TX.setLevel(m_buffer[3]);
-        DEBUG2("Setting RX Level to", m_buffer[1U]);
-        DEBUG2("Setting Mode 1 TX Level to", m_buffer[2U]);
-        DEBUG2("Setting Mode 2 TX Level to", m_buffer[3U]);
+        LOG_GENERAL_INFO("Setting RX Level to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting Mode 1 TX Level to", m_buffer[2U]);
+        LOG_GENERAL_INFO("Setting Mode 2 TX Level to", m_buffer[3U]);
+      } else if (m_ptr == 5U) {
+        io.setRXLevel(m_buffer[1U]);
+        ax25TX.setLevel(m_buffer[2]);
+        mode2TX.setLevel(m_buffer[3]);
+        mode3TX.setLevel(m_buffer[4]);
+        LOG_GENERAL_INFO("Setting RX Level to", m_buffer[1U]);
+        LOG_GENERAL_INFO("Setting Mode 1 TX Level to", m_buffer[2U]);
+        LOG_GENERAL_INFO("Setting Mode 2 TX Level to", m_buffer[3U]);
+        LOG_GENERAL_INFO("Setting Mode 3 TX Level to", m_buffer[4U]);
       }
       break;
+    case KISS_TYPE_SET_SPEED:
+      if (m_ptr == 5U)
+        setSpeed((m_buffer[1U] << 24) | (m_buffer[2U] << 16) | (m_buffer[3U] << 8) | (m_buffer[4U] << 0));
+      break;
+    case KISS_TYPE_STATISTICS:
+      if (m_ptr == 1U || m_ptr == 2U) {
+        uint8_t buffer[STATS_LENGTH];
+        uint16_t length = stats.encode(buffer);
+        writeKISSData(KISS_TYPE_STATISTICS, buffer, length);
+
+        // A non-zero argument resets the counters after they have been sent
+        if ((m_ptr == 2U) && (m_buffer[1U] != 0U)) {
+          stats.reset();
+          LOG_GENERAL_INFO("Statistics reset");
+        }
+      }
+      break;
+    case KISS_TYPE_LOG_LEVELS:
+      setLogLevels(m_buffer + 1U, m_ptr - 1U);
+      break;
     case KISS_TYPE_DATA_WITH_ACK: {
         uint16_t token = (m_buffer[1U] << 8) + (m_buffer[2U] << 0);
+        uint8_t ret = 5U;
         switch (m_mode) {
           case 1U:
-            ax25TX.writeDataAck(token, m_buffer + 3U, m_ptr - 3U);
+          case 5U:
+            ret = ax25TX.writeDataAck(token, m_buffer + 3U, m_ptr - 3U);
             break;
           case 2U:
-            mode2TX.writeDataAck(token, m_buffer + 3U, m_ptr - 3U);
+          case 4U:
+            ret = mode2TX.writeDataAck(token, m_buffer + 3U, m_ptr - 3U);
+            break;
+          case 3U:
+            ret = mode3TX.writeDataAck(token, m_buffer + 3U, m_ptr - 3U);
             break;
         }
+
+        // A frame that could not be queued is acknowledged at once with no airtime, so the host is not left waiting
+        if (ret != 0U)
+          writeKISSAck(token, 0U, 0U);
       }
       break;
     default:
-      DEBUG2("Unhandled KISS frame type", m_buffer[0U]);
+      LOG_GENERAL_INFO("Unhandled KISS frame type", m_buffer[0U]);
       break;
   }
 }
 
 void CSerialPort::writeKISSData(uint8_t type, const uint8_t* data, uint16_t length)
 {
-  uint8_t buffer[2U];
+  queueKISSData(type, data, length, 0U, NULL, 0U);
+}
 
-  buffer[0U] = KISS_FEND;
-  buffer[1U] = type | (KISS_ADDRESS << 4);
-  writeInt(1U, buffer, 2U);
+// A received data frame, followed by its timestamps when they are switched on, queued so that the host gets
+// both or neither
+void CSerialPort::writeKISSRXData(const uint8_t* data, uint16_t length, uint32_t start)
+{
+  if (!m_timestamps) {
+    queueKISSData(KISS_TYPE_DATA, data, length, 0U, NULL, 0U);
+    return;
+  }
 
-  for (uint16_t i = 0U; i < length; i++) {
-    buffer[0U] = data[i];
+  uint8_t stamps[12U];
+  encodeTimestamps(start, stamps);
 
-    switch (buffer[0U]) {
-      case KISS_FEND:
-        buffer[0U] = KISS_FESC;
-        buffer[1U] = KISS_TFEND;
-        writeInt(1U, buffer, 2U);
-        break;
-      case KISS_FESC:
-        buffer[0U] = KISS_FESC;
-        buffer[1U] = KISS_TFESC;
-        writeInt(1U, buffer, 2U);
+  queueKISSData(KISS_TYPE_DATA, data, length, KISS_TYPE_TIMESTAMPS, stamps, 12U);
+}
+
+void CSerialPort::queueKISSData(uint8_t type1, const uint8_t* data1, uint16_t length1, uint8_t type2, const uint8_t* data2, uint16_t length2)
+{
+  // Frames are queued unencoded and sent as the host serial port has space, so a slow host never blocks the
+  // receivers or overruns the UART
+  uint16_t total1 = length1 + 1U;
+  uint16_t total2 = (data2 != NULL) ? (length2 + 1U) : 0U;
+  uint16_t frames = (data2 != NULL) ? 2U : 1U;
+  if ((total1 + total2) > sizeof(m_current)) {
+    stats.increment(STATS_HOST_DROPS);
+    LOG_GENERAL_ERROR("SerialPort: frame too long to queue", length1);
+    return;
+  }
+
+  while ((m_rxQueue.getSpace() < (total1 + total2)) || (m_rxLengths.getSpace() < frames)) {
+#if RX_QUEUE_DROP_OLDEST == 1
+    uint16_t oldest = 0U;
+    m_rxLengths.get(oldest);
+
+    uint16_t joined = 0U;
+    if ((oldest & RX_QUEUE_JOINED) == RX_QUEUE_JOINED) {
+      m_rxLengths.get(joined);
+      oldest &= ~RX_QUEUE_JOINED;
+    }
+
+    uint8_t c;
+    for (uint16_t i = 0U; i < (oldest + joined); i++)
+      m_rxQueue.get(c);
+
+    if (m_speedFrames > 0U)
+      m_speedFrames--;
+    if ((joined > 0U) && (m_speedFrames > 0U))
+      m_speedFrames--;
+
+    stats.increment(STATS_HOST_DROPS);
+    LOG_GENERAL_INFO("SerialPort: queue full, dropped the oldest frame, total dropped", stats.get(STATS_HOST_DROPS));
+#else
+    stats.increment(STATS_HOST_DROPS);
+    LOG_GENERAL_INFO("SerialPort: queue full, dropped the new frame, total dropped", stats.get(STATS_HOST_DROPS));
+    return;
+#endif
+  }
+
+  m_rxQueue.put(type1 | (KISS_ADDRESS << 4));
+  m_rxQueue.put(data1, length1);
+
+  if (data2 != NULL) {
+    m_rxLengths.put(total1 | RX_QUEUE_JOINED);
+
+    m_rxQueue.put(type2 | (KISS_ADDRESS << 4));
+    m_rxQueue.put(data2, length2);
+    m_rxLengths.put(total2);
+  } else {
+    m_rxLengths.put(total1);
+  }
+
+  writeQueue();
+}
+
+void CSerialPort::writeQueue()
+{
+  // Hold received frames until the host is known to be at the new speed
+  if (m_speedState == SPEEDS_CONFIRM)
+    return;
+
+  uint16_t space = availableForWriteInt(1U);
+
+  // The frame being sent is taken out of the queue so that dropping the oldest never touches it, along with
+  // the frame joined to it. It is KISS encoded into a staging buffer, position zero being the opening FEND and
+  // one past its end the closing one
+  uint8_t buffer[KISS_STAGING_LENGTH];
+  uint16_t n = 0U;
+
+  for (;;) {
+    if (m_currentLen == 0U) {
+      // While switching, frames queued after the speed reply are held for the new speed
+      if ((m_speedState == SPEEDS_SWITCH) && (m_speedFrames == 0U))
         break;
-      default:
-        writeInt(1U, buffer, 1U);
+
+      uint16_t length = 0U;
+      if (!m_rxLengths.get(length))
         break;
+
+      if (m_speedFrames > 0U)
+        m_speedFrames--;
+
+      uint16_t joined = 0U;
+      if ((length & RX_QUEUE_JOINED) == RX_QUEUE_JOINED) {
+        m_rxLengths.get(joined);
+        length &= ~RX_QUEUE_JOINED;
+
+        if (m_speedFrames > 0U)
+          m_speedFrames--;
+      }
+
+      m_rxQueue.get(m_current, length + joined);
+      m_currentLen    = length;
+      m_currentPtr    = 0U;
+      m_currentOffset = 0U;
+      m_currentNext   = joined;
+    }
+
+    while (m_currentPtr <= (m_currentLen + 1U)) {
+      uint8_t c = KISS_FEND;
+      if ((m_currentPtr > 0U) && (m_currentPtr <= m_currentLen))
+        c = m_current[m_currentOffset + m_currentPtr - 1U];
+
+      bool escape = (m_currentPtr > 0U) && (m_currentPtr <= m_currentLen) && ((c == KISS_FEND) || (c == KISS_FESC));
+      uint16_t needed = escape ? 2U : 1U;
+
+      if (needed > space) {
+        if (n > 0U)
+          writeInt(1U, buffer, n);
+        return;
+      }
+
+      if ((n + needed) > KISS_STAGING_LENGTH) {
+        writeInt(1U, buffer, n);
+        n = 0U;
+      }
+
+      if (escape) {
+        buffer[n++] = KISS_FESC;
+        buffer[n++] = (c == KISS_FEND) ? KISS_TFEND : KISS_TFESC;
+      } else {
+        buffer[n++] = c;
+      }
+
+      space -= needed;
+      m_currentPtr++;
+    }
+
+    // Move on to the joined frame, if there is one
+    m_currentOffset += m_currentLen;
+    m_currentLen     = m_currentNext;
+    m_currentPtr     = 0U;
+    m_currentNext    = 0U;
+  }
+
+  if (n > 0U)
+    writeInt(1U, buffer, n);
+}
+
+// Only the transmitter of the current mode is run, so the frames awaiting acknowledgement by the others
+// would never be acknowledged
+void CSerialPort::flushTokens()
+{
+  if ((m_mode != 1U) && (m_mode != 5U))
+    ax25TX.flushTokens();
+
+  if ((m_mode != 2U) && (m_mode != 4U))
+    mode2TX.flushTokens();
+
+  if (m_mode != 3U)
+    mode3TX.flushTokens();
+}
+
+void CSerialPort::setSpeed(uint32_t speed)
+{
+  // The host confirms a new speed by repeating the command at that speed
+  if (m_speedState == SPEEDS_CONFIRM) {
+    if (speed == m_newSpeed) {
+      m_speed      = m_newSpeed;
+      m_speedState = SPEEDS_NONE;
+      writeSpeed(m_speed);
+      LOG_GENERAL_INFO("SerialPort: host speed confirmed, x100", int16_t(m_speed / 100U));
     }
+    return;
+  }
+
+  if (m_speedState != SPEEDS_NONE)
+    return;
+
+  bool valid = false;
+  for (uint8_t i = 0U; i < SERIAL_SPEEDS_COUNT; i++) {
+    if (speed == SERIAL_SPEEDS[i])
+      valid = true;
+  }
+
+  // An unsupported or unchanged speed gets the current speed in reply
+  if (!valid || (speed == m_speed) || !checkSpeedInt(1U, speed)) {
+    writeSpeed(m_speed);
+    return;
+  }
+
+  // Reply at the current speed, then switch once the reply and the frames queued before it have gone
+  m_newSpeed    = speed;
+  m_speedState  = SPEEDS_SWITCH;
+  m_speedFrames = m_rxLengths.getData() + 1U;
+  writeSpeed(m_newSpeed);
+}
+
+void CSerialPort::processSpeed()
+{
+  switch (m_speedState) {
+    case SPEEDS_SWITCH:
+      if ((m_currentLen > 0U) || (m_speedFrames > 0U))
+        return;
+
+      // Flush the UART
+      writeInt(1U, NULL, 0U, true);
+
+      setSpeedInt(1U, m_newSpeed);
+
+      m_inFrame    = false;
+      m_isEscaped  = false;
+      m_ptr        = 0U;
+      m_speedTimer = io.getSampleCount();
+      m_speedState = SPEEDS_CONFIRM;
+      break;
+
+    case SPEEDS_CONFIRM:
+      if ((io.getSampleCount() - m_speedTimer) < SPEED_CONFIRM_TIME)
+        return;
+
+      // Not confirmed in time, so go back to the old speed
+      setSpeedInt(1U, m_speed);
+
+      m_inFrame    = false;
+      m_isEscaped  = false;
+      m_ptr        = 0U;
+      m_speedState = SPEEDS_NONE;
+      LOG_GENERAL_INFO("SerialPort: host speed not confirmed, reverting");
+      break;
+
+    default:
+      break;
+  }
+}
+
+void CSerialPort::writeSpeed(uint32_t speed)
+{
+  uint8_t buffer[4U];
+  buffer[0U] = (speed >> 24) & 0xFFU;
+  buffer[1U] = (speed >> 16) & 0xFFU;
+  buffer[2U] = (speed >> 8)  & 0xFFU;
+  buffer[3U] = (speed >> 0)  & 0xFFU;
+
+  writeKISSData(KISS_TYPE_SET_SPEED, buffer, 4U);
+}
+
+// The token is returned least significant byte first, the reverse of the order it was received in, as the
+// earlier firmware sent it. When enabled it is followed by the airtime of the packet and the time it waited to
+// be sent, both in samples and most significant byte first
+void CSerialPort::writeKISSAck(uint16_t token, uint32_t airtime, uint32_t wait)
+{
+  uint8_t buffer[10U];
+  buffer[0U] = (token >> 0) & 0xFFU;
+  buffer[1U] = (token >> 8) & 0xFFU;
+
+  if (!m_ackTimes) {
+    writeKISSData(KISS_TYPE_ACK, buffer, 2U);
+    return;
   }
 
-  buffer[0U] = KISS_FEND;
-  writeInt(1U, buffer, 1U);
+  buffer[2U] = (airtime >> 24) & 0xFFU;
+  buffer[3U] = (airtime >> 16) & 0xFFU;
+  buffer[4U] = (airtime >> 8)  & 0xFFU;
+  buffer[5U] = (airtime >> 0)  & 0xFFU;
+
+  buffer[6U] = (wait >> 24) & 0xFFU;
+  buffer[7U] = (wait >> 16) & 0xFFU;
+  buffer[8U] = (wait >> 8)  & 0xFFU;
+  buffer[9U] = (wait >> 0)  & 0xFFU;
+
+  writeKISSData(KISS_TYPE_ACK, buffer, 10U);
+}
+
+// Sent after a received frame, the sample index of its sync, of the sample that completed it, and of the
+// newest sample when it was queued for the host. The last two differ by the processing backlog.
+void CSerialPort::encodeTimestamps(uint32_t start, uint8_t* buffer) const
+{
+  uint32_t stamps[3U];
+  stamps[0U] = start;
+  stamps[1U] = io.getRXSampleIndex();
+  stamps[2U] = io.getSampleCount();
+
+  for (uint8_t i = 0U; i < 3U; i++) {
+    buffer[i * 4U + 0U] = (stamps[i] >> 24) & 0xFFU;
+    buffer[i * 4U + 1U] = (stamps[i] >> 16) & 0xFFU;
+    buffer[i * 4U + 2U] = (stamps[i] >> 8)  & 0xFFU;
+    buffer[i * 4U + 3U] = (stamps[i] >> 0)  & 0xFFU;
+  }
+}
+
+void CSerialPort::writeKISSFreqOffset(int16_t offset)
+{
+  if (!m_freqOffsets)
+    return;
+
+  uint8_t buffer[2U];
+  buffer[0U] = uint8_t(offset >> 8);
+  buffer[1U] = uint8_t(offset >> 0);
+
+  writeKISSData(KISS_TYPE_FREQ_OFFSET, buffer, 2U);
 }
 
-void CSerialPort::writeKISSAck(uint16_t token)
+// Levels above those built in are reduced to them, the reply tells the host what it will actually get
+void CSerialPort::setLogLevels(const uint8_t* levels, uint16_t count)
 {
-  writeKISSData(KISS_TYPE_ACK, (uint8_t*)&token, sizeof(uint16_t));
+  for (uint8_t i = 0U; (i < count) && (i < LOGS_COUNT); i++)
+    m_logLevels[i] = (levels[i] < LOG_LEVELS_BUILT[i]) ? levels[i] : LOG_LEVELS_BUILT[i];
+
+  writeKISSData(KISS_TYPE_LOG_LEVELS, m_logLevels, LOGS_COUNT);
+}
+
+bool CSerialPort::isLogging(LOG_SUBSYSTEM subsystem, uint8_t level) const
+{
+  return level <= m_logLevels[subsystem];
 }
 
 void CSerialPort::writeDebug(const char* text)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt("\n");
+  writeDebugEvent(text, NULL, 0U);
 #endif
 }
 
 void CSerialPort::writeDebug(const char* text, int16_t n1)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt(" ");
-  writeDebugInt(n1);
-  writeDebugInt("\n");
+  int16_t args[] = { n1 };
+  writeDebugEvent(text, args, 1U);
 #endif
 }
 
 void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt(" ");
-  writeDebugInt(n1);
-  writeDebugInt(" ");
-  writeDebugInt(n2);
-  writeDebugInt("\n");
+  int16_t args[] = { n1, n2 };
+  writeDebugEvent(text, args, 2U);
 #endif
 }
 
 void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n3)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt(" ");
-  writeDebugInt(n1);
-  writeDebugInt(" ");
-  writeDebugInt(n2);
-  writeDebugInt(" ");
-  writeDebugInt(n3);
-  writeDebugInt("\n");
+  int16_t args[] = { n1, n2, n3 };
+  writeDebugEvent(text, args, 3U);
 #endif
 }
 
 void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n3, int16_t n4)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt(" ");
-  writeDebugInt(n1);
-  writeDebugInt(" ");
-  writeDebugInt(n2);
-  writeDebugInt(" ");
-  writeDebugInt(n3);
-  writeDebugInt(" ");
-  writeDebugInt(n4);
-  writeDebugInt("\n");
+  int16_t args[] = { n1, n2, n3, n4 };
+  writeDebugEvent(text, args, 4U);
 #endif
 }
 
 void CSerialPort::writeDebug(const char* text, int16_t n1, int16_t n2, int16_t n3, int16_t n4, int16_t n5)
 {
 #if defined(SERIAL_DEBUGGING)
-  writeDebugInt(text);
-  writeDebugInt(" ");
-  writeDebugInt(n1);
-  writeDebugInt(" ");
-  writeDebugInt(n2);
-  writeDebugInt(" ");
-  writeDebugInt(n3);
-  writeDebugInt(" ");
-  writeDebugInt(n4);
-  writeDebugInt(" ");
-  writeDebugInt(n5);
-  writeDebugInt("\n");
+  int16_t args[] = { n1, n2, n3, n4, n5 };
+  writeDebugEvent(text, args, 5U);
 #endif
 }
 
 #if defined(SERIAL_DEBUGGING)
-void CSerialPort::writeDebugInt(const char* text)
+// An event is the flash address of its text, which the host looks up in the firmware ELF file, and the raw
+// arguments. The record is DEBUG_EVENT_SYNC, the argument count, the address and the arguments, both little
+// endian, then an XOR of the bytes after the sync.
+void CSerialPort::writeDebugEvent(const char* text, const int16_t* args, uint8_t count)
 {
-  writeInt(3U, (uint8_t*)text, ::strlen(text));
-}
+  uint8_t record[DEBUG_EVENT_MAX_LENGTH];
+  uint8_t length = encodeDebugEvent(record, uint32_t(uintptr_t(text)), args, count);
 
-void CSerialPort::writeDebugInt(int16_t num)
-{
-  if (num == 0) {
-    writeDebug("0");
-    return;
-  }
+  if (m_debugLost > 0U) {
+    uint8_t lost[DEBUG_EVENT_MAX_LENGTH];
+    int16_t n = (m_debugLost > 32767U) ? 32767 : int16_t(m_debugLost);
+    uint8_t lostLength = encodeDebugEvent(lost, 0U, &n, 1U);
+
+    if (m_debugQueue.getSpace() < (lostLength + length)) {
+      m_debugLost++;
+      return;
+    }
 
-  bool isNegative = false;
+    m_debugQueue.put(lost, lostLength);
+    m_debugLost = 0U;
+  }
 
-  if (num < 0) {
-    isNegative = true;
-    num = -num;
+  if (m_debugQueue.getSpace() < length) {
+    m_debugLost++;
+    return;
   }
 
-  char buffer[10U];
-  uint8_t pos = 0U;
+  m_debugQueue.put(record, length);
+}
 
-  while (num != 0) {
-    int16_t rem = num % 10;
-    buffer[pos++] = rem + '0';
-    num /= 10;
-  }
+uint8_t CSerialPort::encodeDebugEvent(uint8_t* record, uint32_t address, const int16_t* args, uint8_t count) const
+{
+  uint8_t length = 0U;
 
-  if (isNegative)
-    buffer[pos++] = '-';
+  record[length++] = DEBUG_EVENT_SYNC;
+  record[length++] = count;
 
-  buffer[pos] = '\0';
+  record[length++] = (address >> 0)  & 0xFFU;
+  record[length++] = (address >> 8)  & 0xFFU;
+  record[length++] = (address >> 16) & 0xFFU;
+  record[length++] = (address >> 24) & 0xFFU;
 
-  reverse(buffer, pos);
+  for (uint8_t i = 0U; i < count; i++) {
+    record[length++] = (uint16_t(args[i]) >> 0) & 0xFFU;
+    record[length++] = (uint16_t(args[i]) >> 8) & 0xFFU;
+  }
 
-  writeDebugInt(buffer);
+  uint8_t check = 0U;
+  for (uint8_t i = 1U; i < length; i++)
+    check ^= record[i];
+  record[length++] = check;
+
+  return length;
 }
 
-void CSerialPort::reverse(char* buffer, uint8_t length) const
+// Only as much as the display UART has room for is sent, so this never waits on the serial port
+void CSerialPort::writeDebugQueue()
 {
-  uint8_t start = 0U;
-  uint8_t end = length - 1U;
+  uint16_t length = m_debugQueue.getData();
+  if (length == 0U)
+    return;
+
+  int space = availableForWriteInt(3U);
+  if (space <= 0)
+    return;
 
-  while (start < end) {
-    char temp     = buffer[start];
-    buffer[start] = buffer[end];
-    buffer[end]   = temp;
+  if (length > uint16_t(space))
+    length = uint16_t(space);
+  if (length > DEBUG_WRITE_LENGTH)
+    length = DEBUG_WRITE_LENGTH;
 
-    end--;
-    start++;
-  }
+  uint8_t buffer[DEBUG_WRITE_LENGTH];
+  m_debugQueue.get(buffer, length);
+
+  writeInt(3U, buffer, length);
 }
 #endif
 
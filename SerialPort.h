@@ -22,10 +22,18 @@
 #include "Config.h"
 #include "Globals.h"
 
+#include "LogDefines.h"
+#include "RingBuffer.h"
+
 #if !defined(SERIAL_SPEED)
 #define SERIAL_SPEED 115200
 #endif
 
+enum SPEED_STATE {
+  SPEEDS_NONE,
+  SPEEDS_SWITCH,
+  SPEEDS_CONFIRM
+};
 
 class CSerialPort {
 public:
@@ -36,7 +44,11 @@ public:
   void process();
 
   void writeKISSData(uint8_t type, const uint8_t* data, uint16_t length);
-  void writeKISSAck(uint16_t token);
+  void writeKISSAck(uint16_t token, uint32_t airtime, uint32_t wait);
+  void writeKISSRXData(const uint8_t* data, uint16_t length, uint32_t start);
+  void writeKISSFreqOffset(int16_t offset);
+
+  bool isLogging(LOG_SUBSYSTEM subsystem, uint8_t level) const;
 
   void writeDebug(const char* text);
   void writeDebug(const char* text, int16_t n1);
@@ -50,13 +62,44 @@ private:
   uint16_t m_ptr;
   bool     m_inFrame;
   bool     m_isEscaped;
+  bool     m_overflow;
+  CRingBuffer<uint8_t>  m_rxQueue;
+  CRingBuffer<uint16_t> m_rxLengths;
+  uint8_t  m_current[1200U];
+  uint16_t m_currentLen;
+  uint16_t m_currentPtr;
+  uint16_t m_currentOffset;
+  uint16_t m_currentNext;
+  SPEED_STATE m_speedState;
+  uint32_t m_speed;
+  uint32_t m_newSpeed;
+  uint32_t m_speedTimer;
+  uint16_t m_speedFrames;
+  uint32_t m_uartDrops;
+  bool     m_timestamps;
+  bool     m_freqOffsets;
+  bool     m_ackTimes;
+  CRingBuffer<uint8_t> m_debugQueue;
+  uint32_t m_debugLost;
+  uint8_t  m_logLevels[LOGS_COUNT];
 
+  void processKISS(const uint8_t* data, uint16_t length);
   void processMessage();
+  void queueKISSData(uint8_t type1, const uint8_t* data1, uint16_t length1, uint8_t type2, const uint8_t* data2, uint16_t length2);
+  void encodeTimestamps(uint32_t start, uint8_t* buffer) const;
+  void writeQueue();
+  void flushTokens();
+
+  void processSpeed();
+  void setSpeed(uint32_t speed);
+  void writeSpeed(uint32_t speed);
+
+  void setLogLevels(const uint8_t* levels, uint16_t count);
 
 #if defined(SERIAL_DEBUGGING)
-  void writeDebugInt(const char* text);
-  void writeDebugInt(int16_t num);
-  void reverse(char* buffer, uint8_t length) const;
+  void    writeDebugEvent(const char* text, const int16_t* args, uint8_t count);
+  uint8_t encodeDebugEvent(uint8_t* record, uint32_t address, const int16_t* args, uint8_t count) const;
+  void    writeDebugQueue();
 #endif
 
   // Hardware versions
@@ -64,7 +107,11 @@ private:
   int     availableForReadInt(uint8_t n);
   int     availableForWriteInt(uint8_t n);
   uint8_t readInt(uint8_t n);
+  uint16_t readInt(uint8_t n, uint8_t* data, uint16_t length);
   void    writeInt(uint8_t n, const uint8_t* data, uint16_t length, bool flush = false);
+  bool    checkSpeedInt(uint8_t n, int speed);
+  void    setSpeedInt(uint8_t n, int speed);
+  uint32_t getRXDropsInt(uint8_t n);
 };
 
 #endif
@@ -40,6 +40,14 @@ UART5  - TXD PC12 - RXD PD2 (Discovery, MMDVM-Pi, MMDVM-Pi F722 board, MMDVM-F4M
 #if defined(STM32F4XX) || defined(STM32F7XX)
 
 #include "STMUART.h"
+
+// The host port may use DMA, the serial repeater always uses an interrupt per byte
+#if defined(SERIAL_DMA)
+const bool HOST_DMA = true;
+#else
+const bool HOST_DMA = false;
+#endif
+
 extern "C" {
    void USART1_IRQHandler();
    void USART2_IRQHandler();
@@ -58,7 +66,7 @@ void USART1_IRQHandler()
   m_USART1.handleIRQ();
 }
 
-void InitUSART1(int speed)
+void InitUSART1(int speed, bool dma)
 {
    // USART1 - TXD PA9  - RXD PA10 - pins on mmdvm pi board
    GPIO_InitTypeDef GPIO_InitStructure;
@@ -98,9 +106,15 @@ void InitUSART1(int speed)
 
    USART_Cmd(USART1, ENABLE);
 
-   USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+   if (dma) {
+      // RX on DMA2 Stream 2 and TX on DMA2 Stream 7, both on channel 4
+      RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+      m_USART1.initDMA(USART1, DMA2_Stream2, DMA2_Stream7, DMA_Channel_4, DMA_FLAG_TCIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TEIF7 | DMA_FLAG_DMEIF7 | DMA_FLAG_FEIF7);
+   } else {
+      USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
 
-   m_USART1.init(USART1);
+      m_USART1.init(USART1);
+   }
 }
 
 #endif
@@ -116,7 +130,7 @@ void USART2_IRQHandler()
    m_USART2.handleIRQ();
 }
 
-void InitUSART2(int speed)
+void InitUSART2(int speed, bool dma)
 {
    // USART2 - TXD PA2  - RXD PA3
    GPIO_InitTypeDef GPIO_InitStructure;
@@ -156,9 +170,15 @@ void InitUSART2(int speed)
 
    USART_Cmd(USART2, ENABLE);
 
-   USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
+   if (dma) {
+      // RX on DMA1 Stream 5 and TX on DMA1 Stream 6, both on channel 4
+      RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+      m_USART2.initDMA(USART2, DMA1_Stream5, DMA1_Stream6, DMA_Channel_4, DMA_FLAG_TCIF6 | DMA_FLAG_HTIF6 | DMA_FLAG_TEIF6 | DMA_FLAG_DMEIF6 | DMA_FLAG_FEIF6);
+   } else {
+      USART_ITConfig(USART2, USART_IT_RXNE, ENABLE);
 
-   m_USART2.init(USART2);
+      m_USART2.init(USART2);
+   }
 }
 
 #endif
@@ -191,7 +211,7 @@ void USART3_IRQHandler()
 #define USART3_RCC_Periph          RCC_AHB1Periph_GPIOC
 #endif
 
-void InitUSART3(int speed)
+void InitUSART3(int speed, bool dma)
 {
    GPIO_InitTypeDef GPIO_InitStructure;
    USART_InitTypeDef USART_InitStructure;
@@ -230,9 +250,15 @@ void InitUSART3(int speed)
 
    USART_Cmd(USART3, ENABLE);
 
-   USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);
+   if (dma) {
+      // RX on DMA1 Stream 1 and TX on DMA1 Stream 3, both on channel 4
+      RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+      m_USART3.initDMA(USART3, DMA1_Stream1, DMA1_Stream3, DMA_Channel_4, DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3);
+   } else {
+      USART_ITConfig(USART3, USART_IT_RXNE, ENABLE);
 
-   m_USART3.init(USART3);
+      m_USART3.init(USART3);
+   }
 }
 
 #endif
@@ -247,7 +273,7 @@ void UART5_IRQHandler()
    m_UART5.handleIRQ();
 }
 
-void InitUART5(int speed)
+void InitUART5(int speed, bool dma)
 {
    // UART5 - TXD PC12 - RXD PD2
    GPIO_InitTypeDef GPIO_InitStructure;
@@ -291,9 +317,15 @@ void InitUART5(int speed)
 
    USART_Cmd(UART5, ENABLE);
 
-   USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);
+   if (dma) {
+      // RX on DMA1 Stream 0 and TX on DMA1 Stream 7, both on channel 4
+      RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA1, ENABLE);
+      m_UART5.initDMA(UART5, DMA1_Stream0, DMA1_Stream7, DMA_Channel_4, DMA_FLAG_TCIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TEIF7 | DMA_FLAG_DMEIF7 | DMA_FLAG_FEIF7);
+   } else {
+      USART_ITConfig(UART5, USART_IT_RXNE, ENABLE);
 
-   m_UART5.init(UART5);
+      m_UART5.init(UART5);
+   }
 }
 
 #endif
@@ -304,22 +336,22 @@ void CSerialPort::beginInt(uint8_t n, int speed)
    switch (n) {
       case 1U:
          #if defined(STM32F4_DISCOVERY) || defined(STM32F7_NUCLEO)
-         InitUSART3(speed);
+         InitUSART3(speed, HOST_DMA);
          #elif defined(STM32F4_PI) || defined(STM32F4_F4M) || defined(STM32F722_PI) || defined(STM32F722_F7M) || defined(STM32F722_RPT_HAT) || defined(STM32F4_DVM) || defined(STM32F7_DVM) || defined(STM32F4_EDA_405) || defined(STM32F4_EDA_446)
-         InitUSART1(speed);
+         InitUSART1(speed, HOST_DMA);
          #elif defined(STM32F4_NUCLEO) || defined(STM32F4_RPT_HAT_TGO)
-         InitUSART2(speed);
+         InitUSART2(speed, HOST_DMA);
          #elif defined(DRCC_DVM)
-         InitUSART1(speed);
+         InitUSART1(speed, HOST_DMA);
          #endif
          break;
       case 3U:
          #if defined(STM32F4_NUCLEO) && defined(STM32F4_NUCLEO_ARDUINO_HEADER)
-         InitUSART1(speed);
+         InitUSART1(speed, false);
          #elif defined(DRCC_DVM)
-         InitUSART2(speed);
+         InitUSART2(speed, false);
          #else
-         InitUART5(speed);
+         InitUART5(speed, false);
          #endif
          break;
       default:
@@ -405,6 +437,24 @@ uint8_t CSerialPort::readInt(uint8_t n)
    }
 }
 
+uint16_t CSerialPort::readInt(uint8_t n, uint8_t* data, uint16_t length)
+{
+   switch (n) {
+      case 1U:
+         #if defined(STM32F4_DISCOVERY) || defined(STM32F7_NUCLEO)
+         return m_USART3.read(data, length);
+         #elif defined(STM32F4_PI) || defined(STM32F4_F4M) || defined(STM32F722_PI) || defined(STM32F722_F7M) || defined(STM32F722_RPT_HAT) || defined(STM32F4_DVM) || defined(STM32F7_DVM) || defined(STM32F4_EDA_405) || defined(STM32F4_EDA_446)
+         return m_USART1.read(data, length);
+         #elif defined(STM32F4_NUCLEO) || defined(STM32F4_RPT_HAT_TGO)
+         return m_USART2.read(data, length);
+         #elif defined(DRCC_DVM)
+         return m_USART1.read(data, length);
+         #endif
+      default:
+         return 0U;
+   }
+}
+
 void CSerialPort::writeInt(uint8_t n, const uint8_t* data, uint16_t length, bool flush)
 {
    switch (n) {
@@ -447,5 +497,59 @@ void CSerialPort::writeInt(uint8_t n, const uint8_t* data, uint16_t length, bool
    }
 }
 
-#endif
+bool CSerialPort::checkSpeedInt(uint8_t n, int speed)
+{
+   switch (n) {
+      case 1U:
+         #if defined(STM32F4_DISCOVERY) || defined(STM32F7_NUCLEO)
+         return m_USART3.checkSpeed(speed);
+         #elif defined(STM32F4_PI) || defined(STM32F4_F4M) || defined(STM32F722_PI) || defined(STM32F722_F7M) || defined(STM32F722_RPT_HAT) || defined(STM32F4_DVM) || defined(STM32F7_DVM) || defined(STM32F4_EDA_405) || defined(STM32F4_EDA_446)
+         return m_USART1.checkSpeed(speed);
+         #elif defined(STM32F4_NUCLEO) || defined(STM32F4_RPT_HAT_TGO)
+         return m_USART2.checkSpeed(speed);
+         #elif defined(DRCC_DVM)
+         return m_USART1.checkSpeed(speed);
+         #endif
+      default:
+         return false;
+   }
+}
+
+uint32_t CSerialPort::getRXDropsInt(uint8_t n)
+{
+   switch (n) {
+      case 1U:
+         #if defined(STM32F4_DISCOVERY) || defined(STM32F7_NUCLEO)
+         return m_USART3.getRXDrops();
+         #elif defined(STM32F4_PI) || defined(STM32F4_F4M) || defined(STM32F722_PI) || defined(STM32F722_F7M) || defined(STM32F722_RPT_HAT) || defined(STM32F4_DVM) || defined(STM32F7_DVM) || defined(STM32F4_EDA_405) || defined(STM32F4_EDA_446)
+         return m_USART1.getRXDrops();
+         #elif defined(STM32F4_NUCLEO) || defined(STM32F4_RPT_HAT_TGO)
+         return m_USART2.getRXDrops();
+         #elif defined(DRCC_DVM)
+         return m_USART1.getRXDrops();
+         #endif
+      default:
+         return 0U;
+   }
+}
 
+void CSerialPort::setSpeedInt(uint8_t n, int speed)
+{
+   switch (n) {
+      case 1U:
+         #if defined(STM32F4_DISCOVERY) || defined(STM32F7_NUCLEO)
+         m_USART3.setSpeed(speed);
+         #elif defined(STM32F4_PI) || defined(STM32F4_F4M) || defined(STM32F722_PI) || defined(STM32F722_F7M) || defined(STM32F722_RPT_HAT) || defined(STM32F4_DVM) || defined(STM32F7_DVM) || defined(STM32F4_EDA_405) || defined(STM32F4_EDA_446)
+         m_USART1.setSpeed(speed);
+         #elif defined(STM32F4_NUCLEO) || defined(STM32F4_RPT_HAT_TGO)
+         m_USART2.setSpeed(speed);
+         #elif defined(DRCC_DVM)
+         m_USART1.setSpeed(speed);
+         #endif
+         break;
+      default:
+         break;
+   }
+}
+
+#endif
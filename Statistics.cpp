@@ -0,0 +1,72 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+#include "Statistics.h"
+
+const uint16_t SAMPLES_PER_MS = 24U;
+
+CStatistics::CStatistics() :
+m_counters(),
+m_busySamples(0U)
+{
+}
+
+void CStatistics::increment(STATS_COUNTER counter, uint32_t n)
+{
+  m_counters[counter] += n;
+}
+
+void CStatistics::addBusySamples(uint16_t samples)
+{
+  m_busySamples += samples;
+
+  m_counters[STATS_BUSY_TIME] += m_busySamples / SAMPLES_PER_MS;
+  m_busySamples %= SAMPLES_PER_MS;
+}
+
+uint32_t CStatistics::get(STATS_COUNTER counter) const
+{
+  return m_counters[counter];
+}
+
+void CStatistics::reset()
+{
+  for (uint8_t i = 0U; i < STATS_COUNT; i++)
+    m_counters[i] = 0U;
+
+  m_busySamples = 0U;
+}
+
+uint16_t CStatistics::encode(uint8_t* buffer) const
+{
+  uint16_t n = 0U;
+
+  buffer[n++] = STATS_VERSION;
+  buffer[n++] = STATS_COUNT;
+
+  for (uint8_t i = 0U; i < STATS_COUNT; i++) {
+    uint32_t value = m_counters[i];
+    buffer[n++] = (value >> 24) & 0xFFU;
+    buffer[n++] = (value >> 16) & 0xFFU;
+    buffer[n++] = (value >> 8)  & 0xFFU;
+    buffer[n++] = (value >> 0)  & 0xFFU;
+  }
+
+  return n;
+}
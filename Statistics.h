@@ -0,0 +1,72 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Config.h"
+
+#if !defined(STATISTICS_H)
+#define  STATISTICS_H
+
+#include <cstdint>
+
+// The order of these is the order in the KISS statistics reply, new ones go at the end
+enum STATS_COUNTER {
+  STATS_AX25_FRAMES,          // Mode 1 and 5 HDLC frames, counted by each of the three demodulators
+  STATS_FX25_FRAMES,          // Mode 1 and 5 FX.25 frames, as above
+  STATS_AFSK_IL2P_FRAMES,     // Mode 1 and 5 IL2P frames, as above
+  STATS_MODE2_FRAMES,         // Mode 2 and 4 IL2P frames
+  STATS_MODE3_FRAMES,         // Mode 3 HDLC frames
+  STATS_HDLC_CRC_ERRORS,
+  STATS_IL2P_CRC_ERRORS,
+  STATS_RS_CORRECTED,         // IL2P and FX.25 blocks which had errors corrected
+  STATS_RS_FAILED,            // IL2P and FX.25 blocks with too many errors to correct
+  STATS_SYNC_FALSE,           // IL2P syncs followed by an invalid header
+  STATS_RX_OVERFLOWS,
+  STATS_TX_OVERFLOWS,
+  STATS_HOST_DROPS,           // Frames dropped from the queue to the host
+  STATS_PTT_KEYUPS,
+  STATS_BUSY_TIME,            // Time in milliseconds with DCD on
+  STATS_UART_RX_DROPS,        // Bytes from the host lost because the UART receive FIFO was full
+  STATS_COUNT
+};
+
+const uint8_t STATS_VERSION = 1U;
+
+const uint16_t STATS_LENGTH = 2U + STATS_COUNT * 4U;
+
+class CStatistics {
+public:
+  CStatistics();
+
+  void increment(STATS_COUNTER counter, uint32_t n = 1U);
+
+  // Adds samples with DCD on to the busy time, the part of a millisecond left over is carried to the next call
+  void addBusySamples(uint16_t samples);
+
+  uint32_t get(STATS_COUNTER counter) const;
+
+  void reset();
+
+  // The version, the number of counters, and then each counter as 32 bits, most significant byte first
+  uint16_t encode(uint8_t* buffer) const;
+
+private:
+  uint32_t m_counters[STATS_COUNT];
+  uint16_t m_busySamples;
+};
+
+#endif
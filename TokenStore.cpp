@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2023 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -16,50 +16,116 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+#include "Config.h"
+#include "Globals.h"
 #include "TokenStore.h"
 
 #include <cstddef>
 
-const uint8_t MAX_TOKENS = 20U;
+const uint8_t MAX_TOKENS = 50U;
 
 CTokenStore::CTokenStore() :
 m_store(NULL),
+m_head(0U),
 m_count(0U),
-m_ptr(0U)
+m_started(0U),
+m_ended(0U)
 {
-  m_store = new uint16_t[MAX_TOKENS];
+  m_store = new TX_TOKEN[MAX_TOKENS];
 }
 
-bool CTokenStore::add(uint16_t token)
+bool CTokenStore::hasSpace() const
+{
+  return m_count < MAX_TOKENS;
+}
+
+bool CTokenStore::add(uint16_t token, uint32_t startPos, uint32_t endPos)
 {
   if (m_count == MAX_TOKENS)
     return false;
 
-  m_store[m_count] = token;
+  TX_TOKEN& entry = get(m_count);
+  entry.m_token       = token;
+  entry.m_queued      = io.getSampleCount();
+  entry.m_startPos    = startPos;
+  entry.m_endPos      = endPos;
+  entry.m_startSample = 0U;
+  entry.m_endSample   = 0U;
+
   m_count++;
 
   return true;
 }
 
-void CTokenStore::reset()
+// The packets are sent in order, so those started and those ended are each a run from the oldest. The
+// positions wrap, so they are compared by the sign of their difference.
+void CTokenStore::update(uint32_t pos)
 {
-  m_ptr = 0U;
+  while (m_started < m_count) {
+    TX_TOKEN& entry = get(m_started);
+    if (int32_t(pos - entry.m_startPos) < 0)
+      break;
+
+    entry.m_startSample = io.getTXWritten();
+    m_started++;
+  }
+
+  while (m_ended < m_started) {
+    TX_TOKEN& entry = get(m_ended);
+    if (int32_t(pos - entry.m_endPos) < 0)
+      break;
+
+    entry.m_endSample = io.getTXWritten();
+    m_ended++;
+  }
 }
 
-bool CTokenStore::next(uint16_t& token)
+void CTokenStore::process()
 {
-  if (m_ptr >= m_count)
-    return false;
+  while (m_ended > 0U) {
+    TX_TOKEN& entry = get(0U);
+    if (int32_t(io.getTXSent() - entry.m_endSample) < 0)
+      break;
 
-  token = m_store[m_ptr];
-  m_ptr++;
+    // The DAC sends a sample every sample period, so the packet started going out its airtime ago
+    uint32_t airtime = entry.m_endSample - entry.m_startSample;
+    int32_t  wait    = int32_t(io.getSampleCount() - airtime - entry.m_queued);
 
-  return true;
+    serial.writeKISSAck(entry.m_token, airtime, (wait > 0) ? uint32_t(wait) : 0U);
+
+    m_head++;
+    if (m_head >= MAX_TOKENS)
+      m_head = 0U;
+
+    m_count--;
+    m_started--;
+    m_ended--;
+  }
 }
 
-void CTokenStore::clear()
+void CTokenStore::flush()
 {
-  m_count = 0U;
-  m_ptr   = 0U;
+  process();
+
+  while (m_count > 0U) {
+    serial.writeKISSAck(get(0U).m_token, 0U, 0U);
+
+    m_head++;
+    if (m_head >= MAX_TOKENS)
+      m_head = 0U;
+
+    m_count--;
+  }
+
+  m_started = 0U;
+  m_ended   = 0U;
 }
 
+TX_TOKEN& CTokenStore::get(uint8_t n)
+{
+  uint8_t i = m_head + n;
+  if (i >= MAX_TOKENS)
+    i -= MAX_TOKENS;
+
+  return m_store[i];
+}
@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2023 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2023,2024 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -23,22 +23,43 @@
 
 #include <cstdint>
 
+// Positions are counted in whatever units the transmitter takes from its queue, samples are those written to
+// and sent from the transmit buffer
+struct TX_TOKEN {
+  uint16_t m_token;
+  uint32_t m_queued;
+  uint32_t m_startPos;
+  uint32_t m_endPos;
+  uint32_t m_startSample;
+  uint32_t m_endSample;
+};
+
 class CTokenStore {
 public:
   CTokenStore();
 
-  bool add(uint16_t token);
+  bool hasSpace() const;
+
+  // Holds the token of a packet occupying the queue from the start position up to, but not including, the end
+  bool add(uint16_t token, uint32_t startPos, uint32_t endPos);
 
-  void reset();
-  bool next(uint16_t& token);
+  // Called with the queue position about to be sent
+  void update(uint32_t pos);
 
-  void clear();
+  // Acknowledges the packets whose last sample has left the DAC
+  void process();
+
+  // Acknowledges every packet, those not yet sent in full with an airtime and wait of zero
+  void flush();
 
 private:
-  uint16_t* m_store;
+  TX_TOKEN* m_store;
+  uint8_t   m_head;
   uint8_t   m_count;
-  uint8_t   m_ptr;
+  uint8_t   m_started;
+  uint8_t   m_ended;
+
+  TX_TOKEN& get(uint8_t n);
 };
 
 #endif
-
@@ -0,0 +1,255 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Renders the binary debug events sent by the modem on its display serial port as text. The text of
+// each event is looked up in the ELF file of the firmware that is running on the modem.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <elf.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+const uint8_t  DEBUG_EVENT_SYNC = 0xA5U;
+const uint8_t  DEBUG_EVENT_MAX_ARGS = 5U;
+const uint16_t DEBUG_EVENT_HEADER_LENGTH = 1U + 1U + 4U;
+
+struct CSection {
+  uint32_t m_address;
+  uint32_t m_length;
+  uint32_t m_offset;
+};
+
+class CFirmware {
+public:
+  bool load(const char* fileName)
+  {
+    FILE* fp = ::fopen(fileName, "rb");
+    if (fp == NULL) {
+      ::fprintf(stderr, "DebugDecoder: cannot open %s\n", fileName);
+      return false;
+    }
+
+    uint8_t buffer[4096U];
+    size_t n;
+    while ((n = ::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+      m_image.insert(m_image.end(), buffer, buffer + n);
+    ::fclose(fp);
+
+    if (m_image.size() < sizeof(Elf32_Ehdr) || ::memcmp(m_image.data(), ELFMAG, SELFMAG) != 0 || m_image[EI_CLASS] != ELFCLASS32) {
+      ::fprintf(stderr, "DebugDecoder: %s is not a 32-bit ELF file\n", fileName);
+      return false;
+    }
+
+    Elf32_Ehdr header;
+    ::memcpy(&header, m_image.data(), sizeof(Elf32_Ehdr));
+
+    for (uint16_t i = 0U; i < header.e_shnum; i++) {
+      size_t pos = header.e_shoff + i * header.e_shentsize;
+      if ((pos + sizeof(Elf32_Shdr)) > m_image.size())
+        break;
+
+      Elf32_Shdr section;
+      ::memcpy(&section, m_image.data() + pos, sizeof(Elf32_Shdr));
+
+      // Only sections that are loaded into the flash hold the event text
+      if (section.sh_type != SHT_PROGBITS || (section.sh_flags & SHF_ALLOC) == 0U)
+        continue;
+      if ((section.sh_offset + section.sh_size) > m_image.size())
+        continue;
+
+      CSection s = { section.sh_addr, section.sh_size, section.sh_offset };
+      m_sections.push_back(s);
+    }
+
+    return !m_sections.empty();
+  }
+
+  bool find(uint32_t address, std::string& text) const
+  {
+    for (const CSection& s : m_sections) {
+      if (address < s.m_address || address >= (s.m_address + s.m_length))
+        continue;
+
+      uint32_t offset = s.m_offset + (address - s.m_address);
+      uint32_t end    = s.m_offset + s.m_length;
+
+      text.clear();
+      while (offset < end && m_image[offset] != 0U)
+        text += char(m_image[offset++]);
+
+      return offset < end;
+    }
+
+    return false;
+  }
+
+private:
+  std::vector<uint8_t>  m_image;
+  std::vector<CSection> m_sections;
+};
+
+static speed_t getSpeed(unsigned long speed)
+{
+  switch (speed) {
+    case 9600UL:   return B9600;
+    case 19200UL:  return B19200;
+    case 38400UL:  return B38400;
+    case 57600UL:  return B57600;
+    case 115200UL: return B115200;
+    default:       return B0;
+  }
+}
+
+static bool setRaw(int fd, unsigned long speed)
+{
+  termios t;
+  if (::tcgetattr(fd, &t) < 0)
+    return true;    // Not a terminal, a captured file
+
+  speed_t s = getSpeed(speed);
+  if (s == B0) {
+    ::fprintf(stderr, "DebugDecoder: unsupported speed %lu\n", speed);
+    return false;
+  }
+
+  ::cfmakeraw(&t);
+  ::cfsetispeed(&t, s);
+  ::cfsetospeed(&t, s);
+  t.c_cc[VMIN]  = 1;
+  t.c_cc[VTIME] = 0;
+
+  if (::tcsetattr(fd, TCSANOW, &t) < 0) {
+    ::fprintf(stderr, "DebugDecoder: cannot set the serial port parameters\n");
+    return false;
+  }
+
+  return true;
+}
+
+// Decodes as many whole events as there are in the buffer and returns the number of bytes used. A
+// record with a bad check byte or an unknown address is taken to be a false sync and skipped a byte.
+static size_t decode(const CFirmware& firmware, const uint8_t* data, size_t length)
+{
+  size_t pos = 0U;
+
+  while (pos < length) {
+    if (data[pos] != DEBUG_EVENT_SYNC) {
+      pos++;
+      continue;
+    }
+
+    if ((length - pos) < 2U)
+      break;
+
+    uint8_t count = data[pos + 1U];
+    if (count > DEBUG_EVENT_MAX_ARGS) {
+      pos++;
+      continue;
+    }
+
+    size_t recordLength = DEBUG_EVENT_HEADER_LENGTH + count * 2U + 1U;
+    if ((length - pos) < recordLength)
+      break;
+
+    const uint8_t* record = data + pos;
+
+    uint8_t check = 0U;
+    for (size_t i = 1U; i < (recordLength - 1U); i++)
+      check ^= record[i];
+
+    uint32_t address = (uint32_t(record[2U]) << 0) | (uint32_t(record[3U]) << 8) | (uint32_t(record[4U]) << 16) | (uint32_t(record[5U]) << 24);
+
+    int16_t args[DEBUG_EVENT_MAX_ARGS];
+    for (uint8_t i = 0U; i < count; i++)
+      args[i] = int16_t(uint16_t(record[6U + i * 2U]) | (uint16_t(record[7U + i * 2U]) << 8));
+
+    if (check != record[recordLength - 1U]) {
+      pos++;
+      continue;
+    }
+
+    std::string text;
+
+    if (address == 0U && count == 1U) {
+      ::printf("*** %d debug events lost\n", args[0U]);
+    } else if (firmware.find(address, text)) {
+      ::printf("%s", text.c_str());
+      for (uint8_t i = 0U; i < count; i++)
+        ::printf(" %d", args[i]);
+      ::printf("\n");
+    } else {
+      pos++;
+      continue;
+    }
+
+    ::fflush(stdout);
+
+    pos += recordLength;
+  }
+
+  return pos;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3) {
+    ::fprintf(stderr, "Usage: DebugDecoder <firmware.elf> <port|file> [speed]\n");
+    return 1;
+  }
+
+  CFirmware firmware;
+  if (!firmware.load(argv[1]))
+    return 1;
+
+  int fd = ::open(argv[2], O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    ::fprintf(stderr, "DebugDecoder: cannot open %s\n", argv[2]);
+    return 1;
+  }
+
+  unsigned long speed = (argc > 3) ? ::strtoul(argv[3], NULL, 10) : 38400UL;
+  if (!setRaw(fd, speed)) {
+    ::close(fd);
+    return 1;
+  }
+
+  std::vector<uint8_t> buffer;
+
+  for (;;) {
+    uint8_t data[256U];
+    ssize_t n = ::read(fd, data, sizeof(data));
+    if (n <= 0)
+      break;
+
+    buffer.insert(buffer.end(), data, data + n);
+
+    size_t used = decode(firmware, buffer.data(), buffer.size());
+    buffer.erase(buffer.begin(), buffer.begin() + used);
+  }
+
+  ::close(fd);
+
+  return 0;
+}
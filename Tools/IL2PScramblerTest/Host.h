@@ -0,0 +1,55 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Just enough of the firmware environment to build the IL2P code on a host.
+
+#if !defined(HOST_H)
+#define  HOST_H
+
+#include <cstdint>
+#include <cstring>
+
+// Stop the firmware headers that need the STM32 libraries from being used
+#define  GLOBALS_H
+#define  DEBUG_H
+#define  RINGBUFFER_H
+
+// The scrambler and unscrambler are private
+#define  private public
+
+#define  LOG_IL2P_TRACE(...)     do { } while (false)
+
+enum STATS_COUNTER {
+  STATS_RS_CORRECTED,
+  STATS_RS_FAILED
+};
+
+class CHostStatistics {
+public:
+  void increment(STATS_COUNTER) {}
+};
+
+extern CHostStatistics stats;
+
+template <typename TDATATYPE>
+class CRingBuffer {
+public:
+  void put(const TDATATYPE*, uint16_t) {}
+};
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Host.h"
+
+#include "../../IL2PRS.cpp"
+#include "../../AX25CRC.cpp"
+#include "../../Hamming.cpp"
+#include "../../IL2PRX.cpp"
+
+CHostStatistics stats;
+
+void firmwareUnscramble(uint8_t* buffer, uint16_t length)
+{
+  static CIL2PRX il2p;
+
+  il2p.unscramble(buffer, length);
+}
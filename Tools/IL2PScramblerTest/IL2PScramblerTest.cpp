@@ -0,0 +1,147 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the byte wide IL2P scrambler and unscrambler in the firmware against the original bit serial
+// versions, using random blocks of every length that an IL2P block can have.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+const unsigned int TEST_BLOCKS = 200000U;
+
+const uint16_t MAX_BLOCK_LENGTH = 255U;
+
+const uint16_t BIT_MASK_TABLE16[] = {0x0001U, 0x0002U, 0x0004U, 0x0008U, 0x0010U, 0x0020U, 0x0040U, 0x0080U, 0x0100U, 0x0200U, 0x0400U, 0x0800U, 0x1000U, 0x2000U, 0x4000U, 0x8000U};
+const uint8_t  BIT_MASK_TABLE8[]  = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT16(p,i,b) p = (b) ? (p | BIT_MASK_TABLE16[(i)]) : (p & ~BIT_MASK_TABLE16[(i)])
+#define READ_BIT16(p,i)    (p & BIT_MASK_TABLE16[(i)])
+
+#define WRITE_BIT8(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE8[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE8[(i)&7])
+#define READ_BIT8(p,i)    (p[(i)>>3] & BIT_MASK_TABLE8[(i)&7])
+
+extern void firmwareScramble(uint8_t* buffer, uint16_t length);
+extern void firmwareUnscramble(uint8_t* buffer, uint16_t length);
+
+static void serialScramble(uint8_t* buffer, uint16_t length)
+{
+  const uint16_t bitLength = length * 8U;
+
+  uint16_t sr = 0x000FU;
+
+  uint16_t pos = 0U;
+  for (uint16_t i = 0U; i < bitLength; i++) {
+    bool b  = READ_BIT8(buffer, i) != 0U;
+    bool fb = READ_BIT16(sr, 0U) != 0U;
+
+    sr >>= 1;
+
+    WRITE_BIT16(sr, 8U, b);
+
+    if (fb)
+      sr ^= 0x0108U;
+
+    b = READ_BIT16(sr, 3U) != 0U;
+
+    if (i > 4U) {
+      WRITE_BIT8(buffer, pos, b);
+      pos++;
+    }
+  }
+
+  for (uint8_t i = 0U; i < 5U; i++, pos++) {
+    bool fb = READ_BIT16(sr, 0U) != 0U;
+
+    sr >>= 1;
+
+    if (fb)
+      sr ^= 0x0108U;
+
+    bool b = READ_BIT16(sr, 3U) != 0U;
+    WRITE_BIT8(buffer, pos, b);
+  }
+}
+
+static void serialUnscramble(uint8_t* buffer, uint16_t length)
+{
+  const uint16_t bitLength = length * 8U;
+
+  uint16_t sr = 0x01F0U;
+
+  for (uint16_t i = 0U; i < bitLength; i++) {
+    bool b = READ_BIT8(buffer, i) != 0U;
+
+    if (b)
+      sr ^= 0x0211U;
+
+    b = READ_BIT16(sr, 0U) != 0U;
+
+    sr >>= 1;
+
+    WRITE_BIT8(buffer, i, b);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)::strtoul(argv[1], NULL, 0) : 1U;
+  ::srand(seed);
+
+  unsigned int scrambleErrors   = 0U;
+  unsigned int unscrambleErrors = 0U;
+  unsigned int roundTripErrors  = 0U;
+
+  for (unsigned int n = 0U; n < TEST_BLOCKS; n++) {
+    uint16_t length = 1U + uint16_t(::rand() % MAX_BLOCK_LENGTH);
+
+    uint8_t data[MAX_BLOCK_LENGTH];
+    for (uint16_t i = 0U; i < length; i++)
+      data[i] = uint8_t(::rand());
+
+    uint8_t serial[MAX_BLOCK_LENGTH], firmware[MAX_BLOCK_LENGTH];
+
+    ::memcpy(serial, data, length);
+    ::memcpy(firmware, data, length);
+    serialScramble(serial, length);
+    firmwareScramble(firmware, length);
+    if (::memcmp(serial, firmware, length) != 0)
+      scrambleErrors++;
+
+    ::memcpy(serial, data, length);
+    ::memcpy(firmware, data, length);
+    serialUnscramble(serial, length);
+    firmwareUnscramble(firmware, length);
+    if (::memcmp(serial, firmware, length) != 0)
+      unscrambleErrors++;
+
+    ::memcpy(firmware, data, length);
+    firmwareScramble(firmware, length);
+    firmwareUnscramble(firmware, length);
+    if (::memcmp(data, firmware, length) != 0)
+      roundTripErrors++;
+  }
+
+  ::printf("IL2PScramblerTest: %u blocks, seed %u\n", TEST_BLOCKS, seed);
+  ::printf("  Scrambler differences:    %u\n", scrambleErrors);
+  ::printf("  Unscrambler differences:  %u\n", unscrambleErrors);
+  ::printf("  Round trip failures:      %u\n", roundTripErrors);
+
+  return (scrambleErrors == 0U && unscrambleErrors == 0U && roundTripErrors == 0U) ? 0 : 1;
+}
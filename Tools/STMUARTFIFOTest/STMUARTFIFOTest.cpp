@@ -0,0 +1,149 @@
+/*
+ *   Copyright (C) 2024 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the UART FIFO bookkeeping used for DMA, the span that can be read without wrapping, advancing
+// the tail over bytes read in place, and moving the head after circular DMA reception including when
+// reception has overtaken the tail and the oldest bytes are lost.
+
+#include "../../STMUARTFIFO.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+const unsigned int TEST_STEPS = 200000U;
+
+static unsigned int errors = 0U;
+
+static void check(bool ok, const char* text, unsigned int step)
+{
+  if (!ok) {
+    if (errors < 10U)
+      ::printf("  Failed: %s at step %u\n", text, step);
+    errors++;
+  }
+}
+
+// Fill the FIFO to leave the tail a few bytes short of the end of the buffer, then check that the span
+// stops at the end and that the rest follows from the start once the tail is advanced
+static void testSpan()
+{
+  CSTMUARTFIFO fifo;
+
+  for (uint16_t i = 0U; i < BUFFER_SIZE - 5U; i++)
+    fifo.put(0U);
+  fifo.advance(BUFFER_SIZE - 5U);
+
+  check(fifo.isEmpty(), "empty after advance", 0U);
+  check(fifo.getSpan() == 0U, "span of an empty FIFO", 0U);
+
+  for (uint16_t i = 0U; i < 12U; i++)
+    fifo.put(uint8_t(i));
+
+  check(fifo.getData() == 12U, "data across the wrap", 0U);
+  check(fifo.getSpan() == 5U, "span stops at the end of the buffer", 0U);
+  check(fifo.getTail()[0U] == 0U && fifo.getTail()[4U] == 4U, "bytes before the wrap", 0U);
+
+  fifo.advance(5U);
+
+  check(fifo.getData() == 7U, "data after advancing to the wrap", 0U);
+  check(fifo.getSpan() == 7U, "span after the wrap", 0U);
+  check(fifo.getTail() == fifo.getBuffer(), "tail at the start of the buffer", 0U);
+  check(fifo.getTail()[0U] == 5U && fifo.getTail()[6U] == 11U, "bytes after the wrap", 0U);
+
+  fifo.advance(7U);
+
+  check(fifo.isEmpty(), "empty after reading everything", 0U);
+}
+
+// Circular DMA writes a numbered stream of bytes into the buffer, and the head is moved up to it after
+// each burst, which is always shorter than the buffer as the DMA interrupts guarantee. The bytes read
+// back in spans must follow on from the last one read, apart from those reported lost.
+static void testReception()
+{
+  CSTMUARTFIFO fifo;
+
+  uint32_t written  = 0U;
+  uint32_t expected = 0U;
+  uint32_t lost     = 0U;
+  uint32_t overruns = 0U;
+
+  volatile uint8_t* buffer = fifo.getBuffer();
+
+  for (unsigned int step = 0U; step < TEST_STEPS; step++) {
+    // Mostly short bursts, with the occasional long one to overrun the reader
+    uint16_t burst = ((::rand() % 32) == 0) ? uint16_t(::rand() % BUFFER_SIZE) : uint16_t(::rand() % 64);
+
+    for (uint16_t i = 0U; i < burst; i++) {
+      buffer[written & BUFFER_MASK] = uint8_t(written);
+      written++;
+    }
+
+    uint16_t data = fifo.getData();
+    uint16_t drop = (data + burst > BUFFER_MASK) ? (data + burst - BUFFER_MASK) : 0U;
+
+    uint16_t n = fifo.setHead(uint16_t(written & BUFFER_MASK));
+    check(n == drop, "bytes lost when reception overtakes the tail", step);
+    check(fifo.getData() == data + burst - n, "data after moving the head", step);
+
+    if (n > 0U)
+      overruns++;
+
+    lost     += n;
+    expected += n;
+
+    // Read some or all of what is waiting, a span at a time
+    uint16_t wanted = uint16_t(::rand() % 128);
+    while (wanted > 0U && !fifo.isEmpty()) {
+      uint16_t span = fifo.getSpan();
+      if (span > wanted)
+        span = wanted;
+
+      const volatile uint8_t* tail = fifo.getTail();
+      check(tail + span <= fifo.getBuffer() + BUFFER_SIZE, "span inside the buffer", step);
+
+      for (uint16_t i = 0U; i < span; i++) {
+        check(tail[i] == uint8_t(expected), "byte read in order", step);
+        expected++;
+      }
+
+      fifo.advance(span);
+      wanted -= span;
+    }
+
+    check(uint32_t(written - expected) == fifo.getData(), "data matches the bytes not yet read", step);
+  }
+
+  ::printf("  Bytes received:  %u\n", written);
+  ::printf("  Bytes lost:      %u in %u overruns\n", lost, overruns);
+}
+
+int main(int argc, char** argv)
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)::strtoul(argv[1], NULL, 0) : 1U;
+  ::srand(seed);
+
+  ::printf("STMUARTFIFOTest: %u steps, seed %u\n", TEST_STEPS, seed);
+
+  testSpan();
+  testReception();
+
+  ::printf("  Failures:        %u\n", errors);
+
+  return (errors == 0U) ? 0 : 1;
+}